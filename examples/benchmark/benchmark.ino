@@ -0,0 +1,104 @@
+/*****************************************************************
+  File:         benchmark.ino
+  Description:  1.Wire interface (Clock Frequency: 400K) is used to communicate with BMD31M090.
+              2.Hardware Serial (BAUDRATE 115200) is used to communicate with Serial Port Monitor.
+              3.Measure the frame time of display() (burst transfer) against the
+                legacy transfer that sends one GDDRAM byte per I2C transaction.
+  connection method: sclPin:SCL(D19) sdaPin:SDA(D18)
+******************************************************************/
+#include "BMD31M090.h"
+
+#define BMD31M090_WIDTH   128        // BMD31M090 Module display width, in pixels
+#define BMD31M090_HEIGHT  64         // BMD31M090 Module display height, in pixels
+#define BMD31M090_ADDRESS 0x3C       // See Schematic "I2C Addr SEL" for address setting,
+// The I2C address can configure: Addr0:0x3C ; Addr1:0x3D
+#define BENCH_FRAMES      20         // Frames per measurement
+
+BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire); //Please uncomment out this line of code if you use HW Wire on BMduino
+//BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1); //Please uncomment out this line of code if you use HW Wire1 on BMduino
+//BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire2); //Please uncomment out this line of code if you use HW Wire1 on BMduino
+
+TwoWire *benchWire = &Wire;          // Must be the same Wire object as BMD31
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("BMD31M090 display() Benchmark Sketch");
+
+  if (BMD31.begin(BMD31M090_ADDRESS) == 4)
+  {
+    Serial.println("BMD31M090: no RAM for the frame buffer, see BMD31M090_Panel<>");   // The constructor allocates it from the heap
+  }
+  delay(100); // Recommended initial setting delay value.
+
+  uint32_t legacyTime = bench_legacyDisplay();
+  uint32_t burstTime = bench_burstDisplay();
+
+  Serial.print("Per-byte transfer, us/frame: ");
+  Serial.println(legacyTime);
+  Serial.print("Burst transfer, us/frame:    ");
+  Serial.println(burstTime);
+  Serial.print("Speed-up: x");
+  Serial.println((float)legacyTime / burstTime);
+}
+
+void loop()
+{
+}
+
+/* Draw a different pattern each frame so that every frame really changes */
+void drawPattern(uint8_t frame)
+{
+  BMD31.clearDisplay();
+  for (uint8_t x = 0; x < BMD31M090_WIDTH; x += 8)
+  {
+    BMD31.drawLine(x, 0, (x + frame) % BMD31M090_WIDTH, BMD31M090_HEIGHT - 1, pixelColor_WHITE);
+  }
+}
+
+/* Burst transfer: one 0x40 control byte followed by a whole Wire buffer of GDDRAM bytes */
+uint32_t bench_burstDisplay(void)
+{
+  uint32_t start = micros();
+  for (uint8_t frame = 0; frame < BENCH_FRAMES; frame++)
+  {
+    drawPattern(frame);
+    BMD31.display();
+  }
+  return (micros() - start) / BENCH_FRAMES;
+}
+
+/* Legacy transfer: a START/address/control/STOP sequence for every GDDRAM byte
+   of the frame buffer, behind the driver's back (horizontal addressing mode)  */
+uint32_t bench_legacyDisplay(void)
+{
+  uint8_t *frame = BMD31.getBuffer();
+  uint32_t start = micros();
+  for (uint8_t n = 0; n < BENCH_FRAMES; n++)
+  {
+    drawPattern(n);
+    sendLegacyCommand(SET_COLUMNADDR);               // Whole panel : columns 0..127, pages 0..7
+    sendLegacyCommand(0);
+    sendLegacyCommand(BMD31M090_WIDTH - 1);
+    sendLegacyCommand(SET_PAGEADDR);
+    sendLegacyCommand(0);
+    sendLegacyCommand((BMD31M090_HEIGHT / 8) - 1);
+    for (uint16_t i = 0; i < (BMD31M090_WIDTH * BMD31M090_HEIGHT / 8); i++)
+    {
+      benchWire->beginTransmission(BMD31M090_ADDRESS);
+      benchWire->write(0x40);
+      benchWire->write(frame[i]);
+      benchWire->endTransmission();
+    }
+  }
+  BMD31.invalidateState();                          // The driver's window, pointer and dirty spans are stale now
+  return (micros() - start) / BENCH_FRAMES;
+}
+
+void sendLegacyCommand(uint8_t command)
+{
+  benchWire->beginTransmission(BMD31M090_ADDRESS);
+  benchWire->write(0x00);
+  benchWire->write(command);
+  benchWire->endTransmission();
+}
@@ -0,0 +1,55 @@
+/*****************************************************************
+  File:         canvas.ino
+  Description:  1.Wire interface (Clock Frequency: 400K) is used to communicate with BMD31M090.
+              2.Hardware Serial (BAUDRATE 115200) is used to communicate with Serial Port Monitor.
+              3.An icon is composed once on an off-screen canvas and pasted with blit().
+  connection method: sclPin:SCL(D19) sdaPin:SDA(D18)
+******************************************************************/
+#include "BMD31M090.h"
+
+#define BMD31M090_WIDTH   128        // BMD31M090 Module display width, in pixels
+#define BMD31M090_HEIGHT  64         // BMD31M090 Module display height, in pixels
+#define BMD31M090_ADDRESS 0x3C       // See Schematic "I2C Addr SEL" for address setting,
+// The I2C address can configure: Addr0:0x3C ; Addr1:0x3D
+
+#define ICON_WIDTH        24
+#define ICON_HEIGHT       20         // Need not be a multiple of 8
+
+BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire); //Please use &Wire1 or &Wire2 if the module is on HW Wire1 or Wire2
+
+uint8_t iconBuffer[ICON_WIDTH * ((ICON_HEIGHT + 7) / 8)];
+BMD31M090_Canvas icon(ICON_WIDTH, ICON_HEIGHT, iconBuffer);
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("BMD31M090 canvas Sketch");
+
+  if (BMD31.begin(BMD31M090_ADDRESS) == 4)
+  {
+    Serial.println("BMD31M090: no RAM for the frame buffer, see BMD31M090_Panel<>");   // The constructor allocates it from the heap
+  }
+  delay(100); // Recommended initial setting delay value.
+
+  /* Compose the icon off screen */
+  icon.clearDisplay();
+  icon.drawLine(0, 0, ICON_WIDTH - 1, 0, pixelColor_WHITE);
+  icon.drawLine(0, ICON_HEIGHT - 1, ICON_WIDTH - 1, ICON_HEIGHT - 1, pixelColor_WHITE);
+  icon.drawLine(0, 0, 0, ICON_HEIGHT - 1, pixelColor_WHITE);
+  icon.drawLine(ICON_WIDTH - 1, 0, ICON_WIDTH - 1, ICON_HEIGHT - 1, pixelColor_WHITE);
+  icon.drawLine(0, 0, ICON_WIDTH - 1, ICON_HEIGHT - 1, pixelColor_WHITE);
+  icon.drawLine(0, ICON_HEIGHT - 1, ICON_WIDTH - 1, 0, pixelColor_WHITE);
+}
+
+void loop()
+{
+  static int16_t y = -ICON_HEIGHT;
+
+  /* Move the icon down the screen, any y works (page-aligned y is the fastest) */
+  BMD31.clearDisplay();
+  BMD31.blit(icon, 52, y);
+  BMD31.display();
+
+  y = (y < BMD31M090_HEIGHT) ? (y + 1) : -ICON_HEIGHT;
+  delay(20);
+}
@@ -17,13 +17,17 @@ uint8_t t = ' ';
 //BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire); //Please uncomment out this line of code if you use HW Wire on BMduino
 BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire1); //Please uncomment out this line of code if you use HW Wire1 on BMduino
 //BMD31M090     BMD31(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire2); //Please uncomment out this line of code if you use HW Wire1 on BMduino
+//BMD31M090_Panel<BMD31M090_WIDTH, BMD31M090_HEIGHT> BMD31(&Wire1); //Please uncomment out this line of code to allocate the frame buffer statically
 
 void setup()
 {
   Serial.begin(115200);
   Serial.println("BMD31M090 0.96\" OLED Module Sketch");
 
-  BMD31.begin(BMD31M090_ADDRESS);
+  if (BMD31.begin(BMD31M090_ADDRESS) == 4)
+  {
+    Serial.println("BMD31M090: no RAM for the frame buffer, see BMD31M090_Panel<>");   // The constructor allocates it from the heap
+  }
   delay(100); // Recommended initial setting delay value.
 
   /* Test Function: drawString to draw font(6x8) Hello World! */
@@ -41,6 +45,12 @@ void setup()
   /* Test Function: drawFastHLine and drawFastVLine */
   test_drawFastHLine_drawFastVLine();
 
+  /* Test Function: fillRect, clearRect and invertRect */
+  test_fillRect();
+
+  /* Test Function: circles, ellipses, rounded rectangles and triangles */
+  test_drawShapes();
+
   /* Test Function: drawBitMap to show BestModule_LOGO and NameBestModule_LOGO */
   test_drawBitmap();
 
@@ -179,6 +189,39 @@ void test_drawFastHLine_drawFastVLine(void)
   delay(500);
 }
 
+void test_fillRect(void)
+{
+  BMD31.clearDisplay();
+  BMD31.fillRect(8, 4, 112, 56, pixelColor_WHITE);
+  BMD31.clearRect(16, 12, 96, 40);
+  BMD31.display();
+  delay(500);
+
+  for (uint8_t row = 0; row < 64; row += 16)
+  {
+    BMD31.invertRect(0, row, 128, 16);              // Highlight one menu line at a time
+    BMD31.display();
+    delay(250);
+    BMD31.invertRect(0, row, 128, 16);
+  }
+  BMD31.display();
+  delay(500);
+}
+
+void test_drawShapes(void)
+{
+  BMD31.clearDisplay();
+  BMD31.drawCircle(20, 20, 18, pixelColor_WHITE);
+  BMD31.fillCircle(20, 20, 10, pixelColor_WHITE);
+  BMD31.drawEllipse(64, 20, 22, 12, pixelColor_WHITE);
+  BMD31.fillTriangle(96, 38, 126, 38, 111, 4, pixelColor_WHITE);
+  BMD31.drawTriangle(96, 38, 126, 38, 111, 4, pixelColor_INVERSE);
+  BMD31.fillRoundRect(4, 44, 56, 18, 6, pixelColor_WHITE);
+  BMD31.drawRoundRect(68, 44, 56, 18, 6, pixelColor_WHITE);
+  BMD31.display();
+  delay(500);
+}
+
 void test_drawBitmap(void)
 {
   /*==========================================================
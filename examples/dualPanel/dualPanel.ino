@@ -0,0 +1,67 @@
+/*****************************************************************
+  File:         dualPanel.ino
+  Description:  1.Wire interface (Clock Frequency: 400K) is used to communicate with two BMD31M090
+                  modules on the same bus (Addr0:0x3C and Addr1:0x3D).
+              2.Hardware Serial (BAUDRATE 115200) is used to communicate with Serial Port Monitor.
+              3.The modules first show one 256x64 canvas, then mirror the same picture.
+  connection method: sclPin:SCL(D19) sdaPin:SDA(D18)
+******************************************************************/
+#include "BMD31M090_Group.h"
+
+#define BMD31M090_WIDTH   128        // BMD31M090 Module display width, in pixels
+#define BMD31M090_HEIGHT  64         // BMD31M090 Module display height, in pixels
+
+BMD31M090     leftPanel(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire);   //Please use &Wire1 or &Wire2 if the modules are on HW Wire1 or Wire2
+BMD31M090     rightPanel(BMD31M090_WIDTH, BMD31M090_HEIGHT, &Wire);
+BMD31M090_Group panels(leftPanel, rightPanel, GROUP_SPANNED);
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("BMD31M090 dual panel Sketch");
+
+  if (leftPanel.begin(BMD31M090_DEVICEADDR0) == 4)
+  {
+    Serial.println("leftPanel: no RAM for the frame buffer, see BMD31M090_Panel<>");   // The constructor allocates it from the heap
+  }
+  if (rightPanel.begin(BMD31M090_DEVICEADDR1) == 4)
+  {
+    Serial.println("rightPanel: no RAM for the frame buffer, see BMD31M090_Panel<>");   // The constructor allocates it from the heap
+  }
+  delay(100); // Recommended initial setting delay value.
+
+  /* Spanned mode: one 256x64 canvas, lines cross the seam between the modules */
+  panels.clearDisplay();
+  for (int16_t x = 0; x < panels.width(); x += 16)
+  {
+    panels.drawLine(x, 0, panels.width() - 1 - x, panels.height() - 1, pixelColor_WHITE);
+  }
+  panels.drawFastHLine(0, panels.height() / 2, panels.width(), pixelColor_WHITE);
+  panels.clearRect(88, 24, 80, 16);
+  panels.drawString(96, displayROW3, (uint8_t *)"256 x 64");
+  panels.display();
+  delay(3000);
+
+  /* Mirror mode: draw once on the left module, both modules show it */
+  panels.setMode(GROUP_MIRROR);
+  leftPanel.clearDisplay();
+  /* panels.drawString() draws into the buffer, BMD31M090::drawString() would write the left module only */
+  panels.drawString(16, displayROW3, (uint8_t *)"Mirror Mode");
+  leftPanel.drawRoundRect(0, 0, BMD31M090_WIDTH, BMD31M090_HEIGHT, 8, pixelColor_WHITE);
+  panels.display();
+  delay(3000);
+}
+
+void loop()
+{
+  static uint8_t x = 0;
+
+  /* Interleaved flush: both modules are refreshed while loop() keeps running */
+  if (!panels.displayBusy())
+  {
+    leftPanel.drawFastVLine(x, 0, BMD31M090_HEIGHT, pixelColor_INVERSE);
+    x = (x + 1) % BMD31M090_WIDTH;
+    panels.displayAsync();
+  }
+  panels.displayPoll();
+}
@@ -0,0 +1,43 @@
+/*****************************************************************
+  File:         pageMode.ino
+  Description:  1.Wire interface (Clock Frequency: 400K) is used to communicate with BMD31M090.
+              2.Hardware Serial (BAUDRATE 115200) is used to communicate with Serial Port Monitor.
+              3.Page mode : the frame is rendered one page at a time into a 128-byte
+                page buffer instead of a 1024-byte frame buffer.
+  connection method: sclPin:SCL(D19) sdaPin:SDA(D18)
+******************************************************************/
+#include "BMD31M090.h"
+
+#define BMD31M090_WIDTH   128        // BMD31M090 Module display width, in pixels
+#define BMD31M090_HEIGHT  64         // BMD31M090 Module display height, in pixels
+#define BMD31M090_ADDRESS 0x3C       // See Schematic "I2C Addr SEL" for address setting,
+// The I2C address can configure: Addr0:0x3C ; Addr1:0x3D
+
+BMD31M090_PagePanel<BMD31M090_WIDTH, BMD31M090_HEIGHT> BMD31(&Wire); //Please use &Wire1 or &Wire2 if the module is on HW Wire1 or Wire2
+
+uint8_t counter = 0;
+
+/* Called once per page : draw the whole frame, only the current page is kept */
+void drawFrame(void)
+{
+  BMD31.drawLine(0, 0, BMD31M090_WIDTH - 1, BMD31M090_HEIGHT - 1, pixelColor_WHITE);
+  BMD31.drawLine(0, BMD31M090_HEIGHT - 1, BMD31M090_WIDTH - 1, 0, pixelColor_WHITE);
+  BMD31.drawString(16, displayROW0, (uint8_t *)"Page Mode");
+  BMD31.drawNum(48, displayROW6, counter, 3);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("BMD31M090 page mode Sketch");
+
+  BMD31.begin(BMD31M090_ADDRESS);
+  delay(100); // Recommended initial setting delay value.
+}
+
+void loop()
+{
+  BMD31.drawPages(drawFrame);
+  counter++;
+  delay(100);
+}
@@ -0,0 +1,42 @@
+/*****************************************************************
+File:             Arduino.h
+Author:           BEST MODULES CORP.
+Description:      Minimal Arduino core for building the BMD31M090 library on a
+                  host (Linux) with the fake bus transport (BMD31M090_BUS_FAKE)
+Version:          V1.0.3   --  2025-05-29
+******************************************************************/
+
+#ifndef __HOST_ARDUINO_H
+#define __HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)   (*(const uint8_t *)(addr))
+
+typedef uint8_t u8;
+
+inline unsigned long micros(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long)(ts.tv_sec * 1000000UL + ts.tv_nsec / 1000);
+}
+
+inline unsigned long millis(void)
+{
+  return micros() / 1000;
+}
+
+inline void delay(unsigned long ms)
+{
+  unsigned long start = millis();
+  while ((millis() - start) < ms)
+  {
+  }
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*****************************************************************
+File:         benchmark.cpp
+Description:  Host (Linux) benchmark of the BMD31M090 library on the fake bus.
+              Reports CPU time and bus traffic per display() for typical frames
+              (bytes include the address and control byte of each transaction).
+Build:        g++ -O2 -std=c++11 -DBMD31M090_BUS=BMD31M090_BUS_FAKE -Iextras/host -Isrc \
+                  src/BMD31M090.cpp src/BMD31M090_Canvas.cpp src/utility/busTransport.cpp extras/host/benchmark.cpp -o bmd31m090_bench
+******************************************************************/
+#include <stdio.h>
+#include "BMD31M090.h"
+
+#define BENCH_FRAMES  1000
+
+BMD31M090 BMD31(128, 64);
+uint8_t shadowFrame[1024];
+
+typedef void (*DrawFunction)(uint16_t frame);
+
+void drawFullFrame(uint16_t frame)
+{
+  BMD31.clearDisplay();
+  for (uint8_t x = 0; x < 128; x += 8)
+  {
+    BMD31.drawLine(x, 0, (x + frame) % 128, 63, pixelColor_WHITE);
+  }
+}
+
+void drawOnePixel(uint16_t frame)
+{
+  BMD31.drawPixel(frame % 128, (frame / 128) % 64, pixelColor_INVERSE);
+}
+
+void drawSameFrame(uint16_t frame)
+{
+  (void)frame;
+  BMD31.clearDisplay();
+  for (uint8_t x = 0; x < 128; x += 8)
+  {
+    BMD31.drawLine(x, 0, x, 63, pixelColor_WHITE);
+  }
+}
+
+void runBench(const char *name, DrawFunction draw)
+{
+  BMD31M090_Bus &bus = BMD31.getBus();
+
+  BMD31.display();
+  bus.reset();
+  unsigned long start = micros();
+  for (uint16_t frame = 0; frame < BENCH_FRAMES; frame++)
+  {
+    draw(frame);
+    BMD31.display();
+  }
+  unsigned long elapsed = micros() - start;
+
+  printf("%-28s %8.2f us/frame %8.1f transactions/frame %8.1f bytes/frame\n", name,
+         (double)elapsed / BENCH_FRAMES,
+         (double)bus.transactions / BENCH_FRAMES,
+         (double)(2 * bus.transactions + bus.commandBytes + bus.dataBytes) / BENCH_FRAMES);
+}
+
+int main(void)
+{
+  BMD31.begin();
+
+  runBench("full frame", drawFullFrame);
+  runBench("one pixel", drawOnePixel);
+  runBench("same frame redrawn", drawSameFrame);
+
+  BMD31.enableShadowFrame(shadowFrame);
+  runBench("full frame (shadow)", drawFullFrame);
+  runBench("one pixel (shadow)", drawOnePixel);
+  runBench("same frame redrawn (shadow)", drawSameFrame);
+  return 0;
+}
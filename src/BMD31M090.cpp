@@ -6,31 +6,107 @@ Version:     V1.0.3   --  2025-05-29
 ******************************************************************/
 #include "BMD31M090.h"
 
-#ifndef _swapValue_uint8_t
-#define _swapValue_uint8_t(a, b)                                               \
-  {                                                                            \
-    uint8_t t = a;                                                             \
-    a = b;                                                                     \
-    b = t;                                                                     \
-  }
+/* Instrumentation, compiled out unless BMD31M090_ENABLE_STATS is 1               */
+#if BMD31M090_ENABLE_STATS
+#define STATS_ADD(field, value)   (_stats.field += (value))
+#define STATS_TIMER_START()       uint32_t statsStartTime = micros()
+#define STATS_TIMER_STOP(field)   (_stats.field += micros() - statsStartTime)
+#else
+#define STATS_ADD(field, value)
+#define STATS_TIMER_START()
+#define STATS_TIMER_STOP(field)
 #endif
 
-#define ssd1306_swap(a, b)                                                     \
-  (((a) ^= (b)), ((b) ^= (a)), ((a) ^= (b))) ///< No-temp-var swap operation
+/* Asynchronous display transfer states                                          */
+#define FLUSH_IDLE    0                             // No transfer running
+#define FLUSH_WINDOW  1                             // Next step addresses the next span
+#define FLUSH_DATA    2                             // Next step sends a chunk of the current span
+
+/* Controller state mirrored by _stateKnown                                      */
+#define STATE_CONTRAST  0x01                        // _contrast
+#define STATE_INVERT    0x02                        // _inverted
+#define STATE_SCROLL    0x04                        // _scrollActive
+#define STATE_MODE      0x08                        // Horizontal addressing mode selected
+#define STATE_WINDOW    0x10                        // _win* and _ptr*
+
+/* Power-on command sequence, sent as one command stream by begin()              */
+#define INITCMD_MULTIPLEX_INDEX  4                  // Patched with (_displayHeight - 1)
+static const uint8_t initCommandTable[] PROGMEM =
+{
+  SET_DISPLAYOFF,                                   // 0xAE
+  SET_DISPLAYCLOCKDIV, 0x80,                        // 0xD5, The Suggested Ratio 0x80
+  SET_MULTIPLEX, 0x3F,                              // 0xA8, 0x3F - (64 -1)dec -> (0x3F)hex
+  SET_DISPLAYOFFSET, 0x00,                          // 0xD3, No Offset
+  SET_STARTLINE | 0x0,                              // 0x40
+  SET_CHARGEPUMP, 0x14,                             // 0x8D, 0x14, Enable Charge Pump
+  SET_ADDRESSINGMODE, 0x00,                         // 0x20, Horizontal Address Mode
+  SEGMENT_REMAP,                                    // 0xA1
+  COMSCAN_DIRECTION,                                // 0xC8
+  SET_COMPINS, 0x12,                                // 0xDA, COM Pins Hardware Configuration
+  SET_CONTRAST, NORMAL_CONTRAST,                    // 0x81, 0xCF
+  SET_VCOMDETECT, 0x40,                             // 0xDB
+  SET_PRECHARGE, 0xF1,                              // 0xD9
+  DISPLAYALLON_RESUME,                              // 0xA4
+  SET_NORMALDISPLAY,                                // 0xA6
+  DEACTIVATE_SCROLL,                                // 0x2E
+  SET_DISPLAYON                                     // 0xAF
+};
 
 /**********************************************************
 Description: Constructor
 Parameters: width: Display width in pixels
-            height: Display height in pixels
-            theWire: Wire object if your board has more than one Wire interface
+            height: Display height in pixels, at most 64 (see BMD31M090_Canvas)
+            bus: Bus transport. With the default hardware Wire transport, pass the
+                 Wire object (e.g. &Wire1) if your board has more than one Wire interface.
 Return:
-Others:
+Others: The transport type is chosen at compile time with BMD31M090_BUS (see utility/busTransport.h).
+        The frame buffer (width * height / 8 bytes) is allocated from the heap.
+        Use BMD31M090_Panel<width, height> to allocate it statically instead.
+        If the allocation fails begin() returns 4 and drawing does nothing.
+**********************************************************/
+BMD31M090::BMD31M090(uint8_t width, uint8_t height, BMD31M090_Bus bus) :
+  BMD31M090(width, height, (uint8_t *)malloc(width * ((height + 7) / 8)), bus)
+{
+  _ownBuffer = true;
+}
+
+/**********************************************************
+Description: Constructor
+Parameters: width: Display width in pixels
+            height: Display height in pixels, at most 64 (see BMD31M090_Canvas)
+            frameBuffer: Caller-owned memory of width * ((height + 7) / 8) bytes used as
+                         frame buffer (e.g. placed in a DMA-reachable RAM bank), or NULL
+                         for an instance that only shows another one's buffer (see shareBuffer()).
+            bus: Bus transport
+Return:
+Others: Several instances may be given the same memory if they are never drawn at the same time.
+**********************************************************/
+BMD31M090::BMD31M090(uint8_t width, uint8_t height, uint8_t *frameBuffer, BMD31M090_Bus bus) :
+  BMD31M090_Canvas(width, height, frameBuffer), _bus(bus)
+{
+  _buffer = frameBuffer;
+  _ownBuffer = false;
+  _sendFrame = _buffer;
+}
+
+/**********************************************************
+Description: Destructor
+Parameters:
+Return:
+Others: Frees the frame buffer allocated by the constructor. Leaves the aliases of its
+        source, and panels sharing this buffer (see shareBuffer()) return to their own one.
 **********************************************************/
-BMD31M090::BMD31M090(uint8_t width, uint8_t height, TwoWire *theWire)
+BMD31M090::~BMD31M090(void)
 {
-  _displayWidth = width;
-  _displayHeight = height;
-  _wire = theWire;
+  shareBuffer(NULL);
+  while (_bufferAlias)
+  {
+    _bufferAlias->shareBuffer(NULL);                // Unlinks itself from this list
+  }
+  if (_ownBuffer)
+  {
+    free(_buffer);
+  }
 }
 
 /**********************************************************
@@ -38,219 +114,459 @@ Description: Module Initial
 Parameters: deviceAddress: Device Address Of Corresponding BMD31M090 Display.
             clkFrequency: Speed (in Hz) for Wire transmissions in BMD31M090 library calls.
                           (Defaults to 400000 Hz (400 KHz))
-Return:
+                          BMD31M090_CLKAUTO : start at BMD31M090_CLKFREQ, then probeClock() up to BMD31M090_CLKMAX.
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
+        4 : No frame buffer (allocation failed or NULL given to the constructor).
 Others:
 **********************************************************/
-void BMD31M090::begin(uint8_t  i2c_addr, uint32_t clkFrequency)
+uint8_t BMD31M090::begin(uint8_t  i2c_addr, uint32_t clkFrequency)
 {
-  _deviceAddress =  i2c_addr;
-  _clkFrequency = clkFrequency;
-
-  _wire->begin();
-
-  _wire->setClock(_clkFrequency);                   // IIC rate (default rate = 40kHz)
-
-  _wire->setWireTimeout(25000, true);
+  if (_frame == NULL)
+  {
+    return 4;
+  }
 
-  setCommand(SET_DISPLAYOFF);                       // 0xAE
+  _deviceAddress =  i2c_addr;
+  _clkFrequency = (clkFrequency == BMD31M090_CLKAUTO) ? BMD31M090_CLKFREQ : clkFrequency;
 
-  setCommand(SET_DISPLAYCLOCKDIV);                  // 0xD5
-  setCommand(0x80);                                 // The Suggested Ratio 0x80
+  _bus.begin();
 
-  setCommand(SET_MULTIPLEX);                        // 0xA8
-  setCommand(_displayHeight - 1);                   // 0x3F - (64 -1)dec -> (0x3F)hex
+  _bus.setClock(_clkFrequency);                     // IIC rate (default rate = 40kHz)
 
-  setCommand(SET_DISPLAYOFFSET);                    // 0xD3
-  setCommand(0x00);                                 // No Offset
-  setCommand(SET_STARTLINE | 0x0);                  // 0x40
-  setCommand(SET_CHARGEPUMP);                       // 0x8D
-  setCommand(0x14);                                 // 0x14, Enable Charge Pump
+  _bus.setTimeout(_retryTimeout);
 
-  setCommand(SET_ADDRESSINGMODE);                   // 0x20
-  setCommand(0x00);                                 // Horizontal Address Mode
-  setCommand(SEGMENT_REMAP);                        // 0xA1
-  setCommand(COMSCAN_DIRECTION);                    // 0xC8
+  uint8_t initCmd[sizeof(initCommandTable)];
+  for (uint8_t i = 0; i < sizeof(initCommandTable); i++)
+  {
+    initCmd[i] = pgm_read_byte(&initCommandTable[i]);
+  }
+  initCmd[INITCMD_MULTIPLEX_INDEX] = _displayHeight - 1;
+  _stateKnown = 0;
+  uint8_t ret = setCommandList(initCmd, sizeof(initCmd));
+  if (ret == 0)
+  {
+    _stateKnown = STATE_CONTRAST | STATE_INVERT | STATE_SCROLL | STATE_MODE;
+    _contrast = NORMAL_CONTRAST;
+    _inverted = false;
+    _scrollActive = false;
+  }
 
-  setCommand(SET_COMPINS);                          // 0xDA
-  setCommand(0x12);                                 // COM Pins Hardware Configuration
-  setCommand(SET_CONTRAST);                         // 0x81
-  setCommand(NORMAL_CONTRAST);                      // 0xCF
+  clearDisplay();
+  if (ret == 0)
+  {
+    ret = _pageMode ? drawPages(NULL) : display();
+  }
+  if ((ret == 0) && (clkFrequency == BMD31M090_CLKAUTO))
+  {
+    probeClock(BMD31M090_CLKMAX, BMD31M090_CLKTRIALS);
+  }
 
-  setCommand(SET_VCOMDETECT);                       // 0xDB
-  setCommand(0x40);
+  setFont(FontTable_8X16);                          // Default Font Type : 8 * 16
+  return ret;
+}
 
-  setCommand(SET_PRECHARGE);                        // 0xD9
-  setCommand(0xF1);
-  setCommand(DISPLAYALLON_RESUME);                  // 0xA4
-  setCommand(SET_NORMALDISPLAY);                    // 0xA6
-  setCommand(DEACTIVATE_SCROLL);                    // 0x2E
+/**********************************************************
+Description: probe the fastest stable I2C Clock
+Parameters: maxFrequency : Highest clock to try, in Hz.
+            trials : Test bursts per step; a step is accepted only if none of them fails.
+Return: The clock (in Hz) selected, also returned by getClock().
+Others: Steps up through the rates of clockSteps above the current clock. At each step
+        a full data burst rewrites the first bytes of page 0 with their frame buffer
+        content (so nothing visible changes), without retries. The last rate with
+        zero NACKs/timeouts is kept.
+        The panel cannot be read back, so this checks the acknowledge bits only.
+**********************************************************/
+uint32_t BMD31M090::probeClock(uint32_t maxFrequency, uint8_t trials)
+{
+  static const uint32_t clockSteps[] = {400000UL, 600000UL, 800000UL, 1000000UL};
+  uint8_t retryMax = _retryMax;
+  uint8_t burst = (_displayWidth < BMD31M090_DATA_CHUNK) ? _displayWidth : BMD31M090_DATA_CHUNK;
+  uint8_t ret;
 
-  setCommand(SET_DISPLAYON);                        // 0xAF
+  displayWait();
+  _retryMax = 0;                                    // A failure must not be hidden by a retry
+  for (uint8_t i = 0; i < sizeof(clockSteps) / sizeof(clockSteps[0]); i++)
+  {
+    if ((clockSteps[i] <= _clkFrequency) || (clockSteps[i] > maxFrequency))
+    {
+      continue;
+    }
 
-  clearDisplay();
-  display();
+    _bus.setClock(clockSteps[i]);
+    ret = 0;
+    for (uint8_t t = 0; (t < trials) && (ret == 0); t++)
+    {
+      ret = setWindow(0, burst - 1, 0, 0);
+      if (ret == 0)
+      {
+        ret = setDataList(_sendFrame, burst);
+      }
+    }
+    if (ret != 0)
+    {
+      break;
+    }
+    _clkFrequency = clockSteps[i];
+  }
 
-  setFont(FontTable_8X16);                          // Default Font Type : 8 * 16
+  _bus.setClock(_clkFrequency);
+  _retryMax = retryMax;
+  markDirty(0, burst - 1, 0);                       // In case a failed burst left garbage
+  return _clkFrequency;
 }
 
 /**********************************************************
-Description: Clear contents of display buffer
+Description: get I2C Clock
 Parameters:
-Return:
-Others: set all pixels to off.
+Return: The clock (in Hz) in use, e.g. selected by probeClock().
+Others:
 **********************************************************/
-void BMD31M090::clearDisplay(void)
+uint32_t BMD31M090::getClock(void)
 {
-  memset(buffer, 0x00, _displayWidth * ((_displayHeight + 7) / 8));
+  return _clkFrequency;
 }
 
 /**********************************************************
 Description: Push data currently in RAM to Display.
 Parameters:
-Return:
 Others: Drawing operations are not visible until this function is called. 
         Call after each graphics command, or after a whole set of graphics commands, as best needed by one's own application.
+        Only the columns changed since the last call are sent : each page's dirty span is
+        addressed with SET_COLUMNADDR/SET_PAGEADDR and streamed in bursts of BMD31M090_DATA_CHUNK bytes.
+        Consecutive pages with the same span share one address window.
+        With enableShadowFrame(), dirty spans are further reduced to the bytes that really differ from the panel.
+        Blocks until the transfer is done, see displayAsync() for the non-blocking version.
+        Sends nothing in page mode, see drawPages().
+Return: 0 : Success, otherwise the Wire error code of the transaction that failed
+        (the unsent part stays dirty for the next call).
+**********************************************************/
+uint8_t BMD31M090::display(void)
+{
+  STATS_TIMER_START();
+
+  if (_pageMode)
+  {
+    return 0;
+  }
+  displayWait();                                    // Let a running transfer finish first
+  displayAsync();
+  displayWait();
+  STATS_ADD(displayCount, 1);
+  STATS_TIMER_STOP(displayTime);
+  return _flushError;
+}
+
+/**********************************************************
+Description: start an asynchronous display transfer
+Parameters: callback : Function called from displayPoll() when the transfer completes (optional).
+Return: true if the transfer was started, false if another one is still running.
+Others: Takes over the changes drawn so far and returns without touching the bus.
+        Call displayPoll() (e.g. from loop()) until it returns false; each call sends
+        one I2C transaction. Drawing may continue meanwhile; what is drawn after
+        this call is sent by the next transfer.
+        In double-buffer mode the back buffer is swapped to the front first.
+        Not available in page mode, see drawPages().
 **********************************************************/
-void BMD31M090::display(void)
+bool BMD31M090::displayAsync(BMD31M090_Callback callback)
 {
-  uint8_t *ptr = buffer;
+  if ((_flushState != FLUSH_IDLE) || _pageMode || (_frame == NULL))
+  {
+    return false;
+  }
+
+  if (_bufferSource)
+  {
+    _frame = _bufferSource->_sendFrame;             // Follows a double-buffer swap of the source
+    _sendFrame = _frame;
+  }
 
-  setCommand(SET_PAGEADDRESS);                    // Set Page Address
-  setCommand(SET_LOWCOLUMN);                      // Set Column Lower Address
-  setCommand(SET_HIGHCOLUMN);                     // Set Column Higher Address
+  if (_frame != _sendFrame)
+  {
+    uint8_t *front = _frame;
+    _frame = _sendFrame;
+    _sendFrame = front;
+    memcpy(_frame, _sendFrame, _displayWidth * ((_displayHeight + 7) / 8));   // Keep drawing on the latest frame
+  }
 
-  uint16_t count = _displayWidth * ((_displayHeight + 7) / 8);
-  while (count--)
+  for (uint8_t page = 0; page < BMD31M090_MAXPAGES; page++)
   {
-    setData(*ptr++);
+    _flushStart[page] = _dirtyStart[page];
+    _flushEnd[page] = _dirtyEnd[page];
+    _dirtyStart[page] = 0xFF;
+    _dirtyEnd[page] = 0x00;
   }
+
+  flushBegin(callback, true);
+  return true;
 }
 
 /**********************************************************
-Description: Set/Clear/Invert a single pixel.
-Parameters: x: Column of display, 0 at left to (_displayWidth - 1) at right.
-            y: Row of display, 0 at left to (_displayHeight - 1) at right.
-            pixelColor: pixelColor_BLACK,
-                        pixelColor_WHITE,
-                        pixelColor_INVERSE,
+Description: Push a region of RAM to Display.
+Parameters: x_Start : First column, 0 at left to (_displayWidth - 1) at right.
+            page_Start : First page, 0 at top page to 7 at bottom page.
+            x_End : Last column.
+            page_End : Last page.
+Return: 0 : Success, otherwise the Wire error code of the transaction that failed.
+Others: Sends the columns x_Start..x_End of pages page_Start..page_End whether they are
+        marked dirty or not, through the same window/burst path as display()
+        (so with enableShadowFrame() only the bytes that differ are sent).
+        Dirty spans fully covered by the region are cleared.
+        Blocks until the region is sent. Sends nothing in page mode.
+**********************************************************/
+uint8_t BMD31M090::display(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End)
+{
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+
+  if (_pageMode || (_frame == NULL))
+  {
+    return 0;
+  }
+  if (x_End >= _displayWidth)
+  {
+    x_End = _displayWidth - 1;
+  }
+  if (page_End >= pageNum)
+  {
+    page_End = pageNum - 1;
+  }
+  if ((x_Start > x_End) || (page_Start > page_End))
+  {
+    return 0;
+  }
+
+  STATS_TIMER_START();
+  displayWait();
+  if (_bufferSource)
+  {
+    _frame = _bufferSource->_sendFrame;             // Follows a double-buffer swap of the source
+    _sendFrame = _frame;
+  }
+  for (uint8_t page = 0; page < BMD31M090_MAXPAGES; page++)
+  {
+    if ((page < page_Start) || (page > page_End))
+    {
+      _flushStart[page] = 0xFF;
+      _flushEnd[page] = 0x00;
+      continue;
+    }
+
+    _flushStart[page] = x_Start;
+    _flushEnd[page] = x_End;
+    if (_frame != _sendFrame)
+    {
+      /* Double-buffered : the front buffer must keep matching the panel */
+      memcpy(&_sendFrame[x_Start + page * _displayWidth], &_frame[x_Start + page * _displayWidth], x_End - x_Start + 1);
+    }
+
+    /* Trim the dirty span by the region */
+    if ((_dirtyStart[page] >= x_Start) && (_dirtyEnd[page] <= x_End))
+    {
+      _dirtyStart[page] = 0xFF;
+      _dirtyEnd[page] = 0x00;
+    }
+    else if ((_dirtyStart[page] >= x_Start) && (_dirtyStart[page] <= x_End))
+    {
+      _dirtyStart[page] = x_End + 1;
+    }
+    else if ((_dirtyEnd[page] >= x_Start) && (_dirtyEnd[page] <= x_End))
+    {
+      _dirtyEnd[page] = x_Start - 1;
+    }
+  }
+
+  flushBegin(NULL, false);
+  displayWait();
+  STATS_ADD(displayCount, 1);
+  STATS_TIMER_STOP(displayTime);
+  return _flushError;
+}
+
+/**********************************************************
+Description: start the display transfer of the spans in _flushStart/_flushEnd
+Parameters: callback : Function called when the transfer completes (may be NULL).
+            fullFrame : true if the spans hold every change not yet on the panel,
+                        which makes a filled shadow frame valid.
 Return:
 Others:
 **********************************************************/
-void BMD31M090::drawPixel(uint8_t x, uint8_t y, uint8_t pixelColor)
+void BMD31M090::flushBegin(BMD31M090_Callback callback, bool fullFrame)
 {
-  switch (pixelColor)
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+
+  _flushDirtyBytes = 0;
+  for (uint8_t page = 0; page < pageNum; page++)
   {
-    case pixelColor_BLACK:
-      buffer[x + (y / 8) * _displayWidth] &= ~(1 << (y & 7));
-      break;
+    if (_flushStart[page] <= _flushEnd[page])
+    {
+      _flushDirtyBytes += _flushEnd[page] - _flushStart[page] + 1;
+    }
+  }
+
+  _flushSentBytes = 0;
+  _flushError = 0;
+  _flushRetry = 0;
+  _flushFull = fullFrame;
+  _flushPage = 0;
+  _flushFrom = 0;
+  _flushCallback = callback;
+  _flushState = FLUSH_WINDOW;
+}
 
-    case pixelColor_WHITE:
-      buffer[x + (y / 8) * _displayWidth] |= (1 << (y & 7));
+/**********************************************************
+Description: advance an asynchronous display transfer
+Parameters:
+Return: true while the transfer is still running, false when it is done.
+Others: Sends at most one I2C transaction (an address window or one data chunk).
+**********************************************************/
+bool BMD31M090::displayPoll(void)
+{
+  switch (_flushState)
+  {
+    case FLUSH_WINDOW:
+      flushWindow();
       break;
 
-    case pixelColor_INVERSE:
-      buffer[x + (y / 8) * _displayWidth] ^= (1 << (y & 7));
+    case FLUSH_DATA:
+      flushData();
       break;
 
     default:
-      /* BMD31M090 doesn't support colors other than black and white. */
       break;
   }
+  return (_flushState != FLUSH_IDLE);
 }
 
 /**********************************************************
-Description: draw Line.
-Parameters: x_Start : Start point x coordinate.
-            y_Start : Start point y coordinate.
-            x_End : End point x coordinate.
-            y_End : End point y coordinate.
-            pixelColor: pixelColor_BLACK,
-                        pixelColor_WHITE,
-                        pixelColor_INVERSE,
-Return:
+Description: get the Display transfer Status
+Parameters:
+Return: 0 : The last transfer sent the whole frame,
+        otherwise the Wire error code of the transaction that stopped it.
+Others: Meant for displayAsync() users, e.g. from the completion callback.
+**********************************************************/
+uint8_t BMD31M090::getDisplayStatus(void)
+{
+  return _flushError;
+}
+
+/**********************************************************
+Description: check for a running display transfer
+Parameters:
+Return: true if a displayAsync() transfer has not finished yet.
 Others:
 **********************************************************/
-void BMD31M090::drawLine(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t pixelColor)
+bool BMD31M090::displayBusy(void)
 {
-  uint8_t Steep = abs(y_End - y_Start) > abs(x_End - x_Start);
+  return (_flushState != FLUSH_IDLE);
+}
 
-  if (Steep)
+/**********************************************************
+Description: request a Display update
+Parameters:
+Return:
+Others: Use instead of display() when drawing code runs more often than the panel
+        needs to be refreshed. The frame is sent by the next service() call that is
+        at least one frame interval (see setTargetFps()) after the previous frame;
+        all requests until then are coalesced into that single transfer.
+**********************************************************/
+void BMD31M090::requestDisplay(void)
+{
+  if (_framePending)
   {
-    _swapValue_uint8_t(x_Start, y_Start);
-    _swapValue_uint8_t(x_End, y_End);
+    _frameStats.coalescedCount++;
+    return;
   }
+  _framePending = true;
+  _requestTime = micros();
+}
+
+/**********************************************************
+Description: service the frame scheduler
+Parameters:
+Return: true while a frame is pending or being sent.
+Others: Call from loop(). Advances a running transfer by one transaction
+        (see displayPoll()) and starts the transfer of a requested frame when
+        the frame interval has elapsed.
+**********************************************************/
+bool BMD31M090::service(void)
+{
+  uint32_t now;
+  uint32_t due;
 
-  if (x_Start > x_End)
+  if (displayPoll())
   {
-    _swapValue_uint8_t(x_Start, x_End);
-    _swapValue_uint8_t(y_Start, y_End);
+    return true;
+  }
+  if (!_framePending)
+  {
+    return false;
   }
 
-  uint8_t dx, dy;
-  dx = abs(x_End - x_Start);
-  dy = abs(y_End - y_Start);
-  
-  int16_t errValue = dx / 2;
-  int8_t yStep;
+  now = micros();
+  if ((now - _frameTime) < _frameInterval)
+  {
+    return true;                                    // Too early, keep coalescing
+  }
 
-  if (y_Start < y_End)
+  /* Count whole frame intervals that passed while the request waited */
+  due = _frameTime + _frameInterval;
+  if ((int32_t)(_requestTime - due) > 0)
   {
-    yStep = 1;
+    due = _requestTime;
   }
-  else
+  if (_frameInterval)
   {
-    yStep = -1;
+    _frameStats.droppedCount += (now - due) / _frameInterval;
   }
 
-  for (uint8_t i=x_Start; i <= x_End; i++)
+  _frameTime = now;
+  _framePending = false;
+  _frameStats.frameCount++;
+  _fpsFrames++;
+  if ((millis() - _fpsTime) >= 1000)
   {
-    if (Steep) 
-    {
-      drawPixel(y_Start, i, pixelColor);
-    }
-    else
-    {
-      drawPixel(i, y_Start, pixelColor);
-    }
-    errValue -= dy;
-    if (errValue < 0)
-    {
-      y_Start += yStep;
-      errValue += dx;
-    }
+    _frameStats.fps = ((uint32_t)_fpsFrames * 1000) / (millis() - _fpsTime);
+    _fpsTime = millis();
+    _fpsFrames = 0;
   }
+
+  displayAsync();
+  return true;
 }
 
 /**********************************************************
-Description: draw a Horizontal Line
-Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
-            y: Row of display, 0 at left to (_displayHeight - 1) at right.
-            width : Width of Line, in pixels.
-            pixelColor: pixelColor_BLACK,
-                        pixelColor_WHITE,
-                        pixelColor_INVERSE,
+Description: set Target FPS of the frame scheduler
+Parameters: fps : Maximum frames per second started by service(), 0 : no limit
+                  (each service() call sends a pending frame as soon as the bus is free).
 Return:
-Others:
+Others: Defaults to BMD31M090_TARGET_FPS.
 **********************************************************/
-void BMD31M090::drawFastHLine(uint8_t x, uint8_t y, uint8_t width, uint8_t pixelColor)
+void BMD31M090::setTargetFps(uint8_t fps)
 {
-  drawLine(x, y, (x + width - 1), y, pixelColor);
+  _frameInterval = (fps == 0) ? 0 : (1000000UL / fps);
 }
 
 /**********************************************************
-Description: draw a Vertical Line
-Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
-            y: Row of display, 0 at left to (_displayHeight - 1) at right.
-            height : Height of Line, in pixels.
-            pixelColor: pixelColor_BLACK,
-                        pixelColor_WHITE,
-                        pixelColor_INVERSE,
+Description: get Frame scheduler Statistics
+Parameters:
+Return: Achieved FPS, frames started, coalesced requests and dropped frame intervals.
+Others: fps is updated once per second while frames are being sent.
+**********************************************************/
+BMD31M090_FrameStats BMD31M090::getFrameStats(void)
+{
+  return _frameStats;
+}
+
+/**********************************************************
+Description: clear Frame scheduler Statistics
+Parameters:
 Return:
 Others:
 **********************************************************/
-void BMD31M090::drawFastVLine(uint8_t x, uint8_t y, uint8_t height, uint8_t pixelColor)
+void BMD31M090::clearFrameStats(void)
 {
-  drawLine(x, y, x, (y + height - 1), pixelColor);
+  memset(&_frameStats, 0, sizeof(_frameStats));
+  _fpsTime = millis();
+  _fpsFrames = 0;
 }
 
 /**********************************************************
@@ -258,13 +574,26 @@ Description: draw Char
 Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
             page: Row page of display, 0 at top page to 7 at bottom page.
             chr : The char on FontTable.
-Return:
-Others:
+Return: 0 : Success, otherwise the Wire error code of the first transaction that failed
+        (the pages it hit are left for the next display() to restore).
+Others: The glyph is written to the panel directly, not to the frame buffer
+        (in page mode it is rendered into the page buffer). Rows and columns
+        outside the clip rectangle show the frame buffer's pixels.
 **********************************************************/
-void BMD31M090::drawChar(uint8_t x,uint8_t row,uint8_t chr)
+uint8_t BMD31M090::drawChar(uint8_t x,uint8_t row,uint8_t chr)
 {
-  uint8_t  i, charPageNum;
-  uint8_t pageAddr = 0;
+  uint8_t  i, len, charPageNum, pageAddr, x_First, x_Last, mask;
+  uint8_t glyphRow[32];                             // Sent in chunks, so any font width fits
+  uint8_t ret = 0, status;
+  STATS_TIMER_START();
+
+  if (_pageMode || (_frame == NULL))
+  {
+    BMD31M090_Canvas::drawChar(x, row, chr);        // Page mode : render into the page buffer (no buffer : skipped)
+    STATS_ADD(drawCharCount, 1);
+    STATS_TIMER_STOP(drawCharTime);
+    return 0;
+  }
 
   if(x > (_displayWidth-1))
   {
@@ -280,79 +609,69 @@ void BMD31M090::drawChar(uint8_t x,uint8_t row,uint8_t chr)
   /* Calculate how many pages a char need. The height is not a multiple of 8 (1 page), set page + 1. */
   charPageNum = (_fontHeight % 8) ? ((_fontHeight / 8) + 1) : (_fontHeight / 8);
 
-  for (uint8_t j = charPageNum; j>0; j--)
+  /* Clip the glyph to the clip rectangle, the address window would wrap it to the next page */
+  x_First = (x > _clipXStart) ? x : _clipXStart;
+  x_Last = ((x + _fontWidth - 1) < _clipXEnd) ? (x + _fontWidth - 1) : _clipXEnd;
+
+  for (pageAddr = 0; (x_First <= x_Last) && (pageAddr < charPageNum) && ((row + pageAddr) < BMD31M090_MAXPAGES); pageAddr++)
   {
-    setPixelRow(x, row + pageAddr);
-    for(i=0; i<_fontWidth; i++)
+    mask = clipMask(row + pageAddr);                // Rows outside the clip keep the buffer's pixels
+    if (mask == 0)
     {
-      setData(pgm_read_byte(&_font[(chr - 32) * (_fontWidth * ((_fontHeight % 8) ? ((_fontHeight / 8) + 1) : (_fontHeight / 8))) +
-                                    _fontOffset + i + (_fontWidth * pageAddr)]));
+      continue;
     }
-    pageAddr++;
-  }
-}
-
-/**********************************************************
-Description: draw String
-Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
-            page: Row page of display, 0 at top page to 7 at bottom page.
-            str : The string on FontTable.
-Return:
-Others:
-**********************************************************/
-void BMD31M090::drawString(uint8_t x,uint8_t row,uint8_t *str)
-{
-  unsigned char j=0;
-  while (str[j] != '\0')
-  {
-    drawChar(x, row, str[j]);
-
-    /* If it is judged that it exceeds the width of the display, set x = 0 and skip to the next display page */
-    x += _fontWidth;
-    if(x > (128 - _fontWidth))
+    status = setPixelRow(x_First, row + pageAddr);
+    if (status != 0)
+    {
+      ret = ret ? ret : status;
+      continue;                                     // Window not set : the glyph would land at a stale pointer
+    }
+    for (uint16_t col = x_First; col <= x_Last; col += len)
     {
-      x = 0;
-      row += (_fontHeight % 8) ? ((_fontHeight / 8) + 1) : (_fontHeight / 8);
+      len = ((x_Last - col + 1) > (int16_t)sizeof(glyphRow)) ? sizeof(glyphRow) : (x_Last - col + 1);
+      for(i=0; i<len; i++)
+      {
+        glyphRow[i] = (_frame[col + i + (row + pageAddr) * _displayWidth] & ~mask) |
+                      (pgm_read_byte(&_font[(chr - 32) * (_fontWidth * charPageNum) + _fontOffset + (col + i - x) + (_fontWidth * pageAddr)]) & mask);
+      }
+      status = setDataList(glyphRow, len);
+      if (status != 0)
+      {
+        ret = ret ? ret : status;
+        _shadowValid = false;                       // Unknown how much landed, the next display() sends all dirty spans
+        break;
+      }
+      if (_shadow)
+      {
+        memcpy(&_shadow[col + (row + pageAddr) * _displayWidth], glyphRow, len);
+      }
     }
-    j++;
+
+    /* The panel now differs from buffer here, let the next display() restore it */
+    markDirty(x_First, x_Last, row + pageAddr);
   }
+  STATS_ADD(drawCharCount, 1);
+  STATS_TIMER_STOP(drawCharTime);
+  return ret;
 }
 
 /**********************************************************
-Description: draw Num
+Description: draw String
 Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
             page: Row page of display, 0 at top page to 7 at bottom page.
-            num : The num on FontTable.
-            numLen : The num Length.
-Return:
+            str : The string on FontTable.
+Return: 0 : Success, otherwise the Wire error code of the first transaction that failed.
 Others:
 **********************************************************/
-void BMD31M090::drawNum(uint8_t x, uint8_t row,uint32_t num, uint8_t numLen)
+uint8_t BMD31M090::drawString(uint8_t x,uint8_t row,uint8_t *str)
 {
-  uint8_t t,temp;
-  uint8_t enShow=0;
-  for(t=0; t<numLen; t++)
-  {
-    /* One-digit, one-digit display                                                            */
-    temp=(num / setPow(10, (numLen - t - 1))) % 10;
+  uint8_t ret;
+  STATS_TIMER_START();
 
-    if(enShow == 0 && t < (numLen - 1))
-    {
-      /* According the value of 'numLen',
-         If the Highest digit number is 0 (or Highest and the second of topest, etc.), then show "space". */
-      if(temp == 0)
-      {
-        drawChar(x + (_fontWidth * t), row, ' ');
-        continue;
-      }
-      else
-      {
-        enShow = 1; 
-      }
-    }
-    /* Show the num                                                                            */
-    drawChar(x + (_fontWidth * t), row, (temp + '0'));
-  }
+  ret = BMD31M090_Canvas::drawString(x, row, str);
+  STATS_ADD(drawStringCount, 1);
+  STATS_TIMER_STOP(drawStringTime);
+  return ret;
 }
 
 /**********************************************************
@@ -366,49 +685,15 @@ Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
                         pixelColor_WHITE,
                         pixelColor_INVERSE,
 Return:
-Others:
+Others: See BMD31M090_Canvas::drawBitmap().
 **********************************************************/
 void BMD31M090::drawBitmap(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor)
 {
-  int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-  uint8_t b = 0;
+  STATS_TIMER_START();
 
-  for (int16_t j = 0; j < h; j++, y++)
-  {
-    for (int16_t i = 0; i < w; i++)
-    {
-      if (i & 7)
-      {
-        b <<= 1;
-      }
-      else
-      {
-        #if 1
-        /* RAM-resident 1-bit image at the specified */
-        b = Bitmap[(j * byteWidth) + (i / 8)];
-        #else
-        /* PROGMEM-resident 1-bit image at the specified */
-        b = pgm_read_byte(&Bitmap[(j * byteWidth) + (i / 8)]);
-        #endif
-      }
-      if (b & 0x80)
-      {
-        if (((x + i) >= 0) && ((x + i) < _displayWidth) && (y >= 0) && (y < _displayHeight))
-        {
-          drawPixel(x + i, y, (pixelColor == pixelColor_WHITE) ? pixelColor_WHITE : 
-                                                                (pixelColor == pixelColor_BLACK) ? pixelColor_BLACK : pixelColor_INVERSE);
-        }
-      }
-      else
-      {
-        if (((x + i) >= 0) && ((x + i) < _displayWidth) && (y >= 0) && (y < _displayHeight))
-        {
-          drawPixel(x + i, y, (pixelColor == pixelColor_WHITE) ? pixelColor_BLACK : 
-                                                                (pixelColor == pixelColor_BLACK) ? pixelColor_WHITE : pixelColor_INVERSE);
-        }
-      }
-    }
-  }
+  BMD31M090_Canvas::drawBitmap(x, y, Bitmap, w, h, pixelColor);
+  STATS_ADD(drawBitmapCount, 1);
+  STATS_TIMER_STOP(drawBitmapTime);
 }
 
 /**********************************************************
@@ -420,48 +705,67 @@ Parameters: startPage: start scroll Page, 0 at top page to 7 at bottom page.
             scrollVDirection: SCROLLV_NONE,
                               SCROLLV_TOP,
                               SCROLLV_BOTTOM
-Return:
+Return: 0 : Success, otherwise the Wire error code of the scroll commands.
 Others:
 **********************************************************/
-void BMD31M090::startScrollRight(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection)
+uint8_t BMD31M090::startScrollRight(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection)
 {
-  setCommand(DEACTIVATE_SCROLL);                        // Must be deactivated before issuing this command (0x2E).
+  uint8_t cmd[11];
+  uint8_t len = 0;
+  uint8_t ret;
+
+  displayWait();
+  cmd[len++] = DEACTIVATE_SCROLL;                   // Must be deactivated before issuing this command (0x2E).
 
   switch (scrollVDirection)
   {
     case SCROLLV_NONE:
-      setCommand(RIGHT_SCROLL);                       // 0x26, Right Horizontal Scroll
-      setCommand(0x00);                               // A[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = RIGHT_SCROLL;                    // 0x26, Right Horizontal Scroll
+      cmd[len++] = 0x00;                            // A[7:0] Dummy Byte (Set as 00h)
 
-      setCommand(startRow);                          // B[2:0] Define start page address
-      setCommand(scrollSpeed);                        // C[2:0] Set time interval between each scroll step in terms of the frame frequency
-      setCommand(endRow);                            // D[2:0] Define end page address
+      cmd[len++] = startRow;                        // B[2:0] Define start page address
+      cmd[len++] = scrollSpeed;                     // C[2:0] Set time interval between each scroll step in terms of the frame frequency
+      cmd[len++] = endRow;                          // D[2:0] Define end page address
 
-      setCommand(0x00);                               // E[7:0] Dummy Byte (Set as 00h)
-      setCommand(0xFF);                               // F[7:0] Dummy Byte (Set as FFh)
-      setCommand(ACTIVATE_SCROLL);                    // 0x2F
+      cmd[len++] = 0x00;                            // E[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = 0xFF;                            // F[7:0] Dummy Byte (Set as FFh)
+      cmd[len++] = ACTIVATE_SCROLL;                 // 0x2F
       break;
 
     case SCROLLV_TOP:
     case SCROLLV_BOTTOM:
-      setCommand(SET_SCROLLAREA);                     // 0xA3, Set Vertical Scroll Area
-      setCommand(0x00);                               // Set No. of rows in top fixed area
-      setCommand(_displayHeight);                     // Set No. of rows in scroll area (0-63)
+      cmd[len++] = SET_SCROLLAREA;                  // 0xA3, Set Vertical Scroll Area
+      cmd[len++] = 0x00;                            // Set No. of rows in top fixed area
+      cmd[len++] = _displayHeight;                  // Set No. of rows in scroll area (0-63)
 
-      setCommand(RIGHTDIAGONAL_SCROLL);               // 0x29, Vertical and Right Horizontal Scroll
-      setCommand(0x00);                               // A[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = RIGHTDIAGONAL_SCROLL;            // 0x29, Vertical and Right Horizontal Scroll
+      cmd[len++] = 0x00;                            // A[7:0] Dummy Byte (Set as 00h)
 
-      setCommand(startRow);                          // B[2:0] Define start page address
-      setCommand(scrollSpeed);                        // C[2:0] Set time interval between each scroll step in terms of the frame frequency
-      setCommand(endRow);                            // D[2:0] Define end page address
+      cmd[len++] = startRow;                        // B[2:0] Define start page address
+      cmd[len++] = scrollSpeed;                     // C[2:0] Set time interval between each scroll step in terms of the frame frequency
+      cmd[len++] = endRow;                          // D[2:0] Define end page address
 
-      setCommand(scrollVDirection);                   // Vertical Scrolling offset
-      setCommand(ACTIVATE_SCROLL);                    // 0x2F
+      cmd[len++] = scrollVDirection;                // Vertical Scrolling offset
+      cmd[len++] = ACTIVATE_SCROLL;                 // 0x2F
       break;
 
     default:
       break;
   }
+
+  ret = setCommandList(cmd, len);
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_SCROLL;
+    _scrollActive = true;
+  }
+  else
+  {
+    _stateKnown &= ~STATE_SCROLL;
+  }
+  markAllDirty();                                   // Scrolling moves the GDDRAM content
+  _shadowValid = false;
+  return ret;
 }
 
 /**********************************************************
@@ -473,166 +777,915 @@ Parameters: startPage: start scroll Page, 0 at top page to 7 at bottom page.
             scrollVDirection: SCROLLV_NONE,
                               SCROLLV_TOP,
                               SCROLLV_BOTTOMs
-Return:
+Return: 0 : Success, otherwise the Wire error code of the scroll commands.
 Others:
 **********************************************************/
-void BMD31M090::startScrollLeft(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection)
+uint8_t BMD31M090::startScrollLeft(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection)
 {
-  setCommand(DEACTIVATE_SCROLL);                        // Must be deactivated before issuing this command (0x2E).
+  uint8_t cmd[11];
+  uint8_t len = 0;
+  uint8_t ret;
+
+  displayWait();
+  cmd[len++] = DEACTIVATE_SCROLL;                   // Must be deactivated before issuing this command (0x2E).
 
   switch (scrollVDirection)
   {
     case SCROLLV_NONE:
-      setCommand(LEFT_SCROLL);                        // 0x27, Left Horizontal Scroll
-      setCommand(0x00);                               // A[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = LEFT_SCROLL;                     // 0x27, Left Horizontal Scroll
+      cmd[len++] = 0x00;                            // A[7:0] Dummy Byte (Set as 00h)
 
-      setCommand(startRow);                          // B[2:0] Define start page address
-      setCommand(scrollSpeed);                        // C[2:0] Set time interval between each scroll step in terms of the frame frequency
-      setCommand(endRow);                            // D[2:0] Define end page address
+      cmd[len++] = startRow;                        // B[2:0] Define start page address
+      cmd[len++] = scrollSpeed;                     // C[2:0] Set time interval between each scroll step in terms of the frame frequency
+      cmd[len++] = endRow;                          // D[2:0] Define end page address
 
-      setCommand(0x00);                               // E[7:0] Dummy Byte (Set as 00h)
-      setCommand(0xFF);                               // F[7:0] Dummy Byte (Set as FFh)
-      setCommand(ACTIVATE_SCROLL);                    // 0x2F
+      cmd[len++] = 0x00;                            // E[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = 0xFF;                            // F[7:0] Dummy Byte (Set as FFh)
+      cmd[len++] = ACTIVATE_SCROLL;                 // 0x2F
       break;
 
     case SCROLLV_TOP:
     case SCROLLV_BOTTOM:
-      setCommand(SET_SCROLLAREA);                     // 0xA3, Set Vertical Scroll Area
-      setCommand(0x00);                               // Set No. of rows in top fixed area
-      setCommand(_displayHeight);                     // Set No. of rows in scroll area (0-63)
+      cmd[len++] = SET_SCROLLAREA;                  // 0xA3, Set Vertical Scroll Area
+      cmd[len++] = 0x00;                            // Set No. of rows in top fixed area
+      cmd[len++] = _displayHeight;                  // Set No. of rows in scroll area (0-63)
 
-      setCommand(LEFTDIAGONAL_SCROLL);                // 0x2A, Vertical and Left Horizontal Scroll
-      setCommand(0x00);                               // A[7:0] Dummy Byte (Set as 00h)
+      cmd[len++] = LEFTDIAGONAL_SCROLL;             // 0x2A, Vertical and Left Horizontal Scroll
+      cmd[len++] = 0x00;                            // A[7:0] Dummy Byte (Set as 00h)
 
-      setCommand(startRow);                          // B[2:0] Define start page address
-      setCommand(scrollSpeed);                        // C[2:0] Set time interval between each scroll step in terms of the frame frequency
-      setCommand(endRow);                            // D[2:0] Define end page address
+      cmd[len++] = startRow;                        // B[2:0] Define start page address
+      cmd[len++] = scrollSpeed;                     // C[2:0] Set time interval between each scroll step in terms of the frame frequency
+      cmd[len++] = endRow;                          // D[2:0] Define end page address
 
-      setCommand(scrollVDirection);                   // Vertical Scrolling offset
-      setCommand(ACTIVATE_SCROLL);                    // 0x2F
+      cmd[len++] = scrollVDirection;                // Vertical Scrolling offset
+      cmd[len++] = ACTIVATE_SCROLL;                 // 0x2F
       break;
 
     default:
       break;
   }
+
+  ret = setCommandList(cmd, len);
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_SCROLL;
+    _scrollActive = true;
+  }
+  else
+  {
+    _stateKnown &= ~STATE_SCROLL;
+  }
+  markAllDirty();                                   // Scrolling moves the GDDRAM content
+  _shadowValid = false;
+  return ret;
 }
 
 /**********************************************************
 Description: stop a previously-begun scrolling action.
 Parameters:
-Return:
-Others:
+Return: 0 : Success (or nothing to send), otherwise the Wire error code of the command.
+Others: Sends nothing if no scrolling is active.
 **********************************************************/
-void BMD31M090::stopScroll(void)
+uint8_t BMD31M090::stopScroll(void)
 {
-  setCommand(DEACTIVATE_SCROLL);                    // 0x2E
-}
+  uint8_t ret;
 
-/**********************************************************
-Description: set Font
-Parameters: font: fontTable's font name.
-Return:
-Others: Currently support FontTable_8X16 and FontTable_6X8.
-        After begin() is executed, FontTable_8X16 is used by default.
-        (set __fontWidth and _fontHeight by _font[0]&[1])
-**********************************************************/
-void BMD31M090::setFont(const unsigned char* font)
-{
-  _font = font;
-  _fontWidth = pgm_read_byte(&_font[0]);
-  _fontHeight = pgm_read_byte(&_font[1]);
+  if ((_stateKnown & STATE_SCROLL) && !_scrollActive)
+  {
+    return 0;
+  }
+
+  displayWait();
+  ret = setCommand(DEACTIVATE_SCROLL);              // 0x2E
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_SCROLL;
+    _scrollActive = false;
+  }
+  markAllDirty();                                   // Scrolling has moved the GDDRAM content
+  _shadowValid = false;
+  return ret;
 }
 
 /**********************************************************
 Description: set Pixel Page
 Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
             page: Row page of display, 0 at top page to 7 at bottom page.
-Return:
-Others:
+Return: 0 : Success, otherwise the Wire error code of the window commands.
+Others: The address window is opened from (x, row) to the bottom-right corner,
+        so it also resets a window left narrowed by a partial display().
+        Nothing is sent if the window and the GDDRAM pointer are already there.
 **********************************************************/
-void BMD31M090::setPixelRow(uint8_t x, uint8_t row)
+uint8_t BMD31M090::setPixelRow(uint8_t x, uint8_t row)
 {
-  setCommand(SET_PAGEADDRESS + row);               // Set Page Address
-  setCommand(((x & 0xF0) >> 4) | SET_HIGHCOLUMN);   // Set Column Higher Address
-  setCommand((x & 0x0F));                           // Set Column Lower Address
+  displayWait();                                    // The window belongs to a running transfer
+  return setWindow(x, _displayWidth - 1, row, ((_displayHeight + 7) / 8) - 1);
 }
 
 /**********************************************************
 Description: set Dim to display
 Parameters: dim : True for enable dim mode (contrast value : 0x00),
                   False for Normal brightness mode (contrast value : 0xCF).
-Return:
+Return: 0 : Success (or nothing to send), otherwise the Wire error code of the commands.
 Others: Contrast ranges from 00h to FFh, the range is too small to be really useful.
         This function is only set for the lowest contrast and normal contrast.
+        Nothing is sent if the panel already has that contrast.
 **********************************************************/
-void BMD31M090::dim(bool dim)
+uint8_t BMD31M090::dim(bool dim)
 {
-  setCommand(SET_CONTRAST);
-  setCommand(dim ? 0 : NORMAL_CONTRAST);            // if True - set contrast 0 , False - set normal contrast 0xCF
+  const uint8_t cmd[] =
+  {
+    SET_CONTRAST,
+    (uint8_t)(dim ? 0 : NORMAL_CONTRAST)            // if True - set contrast 0 , False - set normal contrast 0xCF
+  };
+  uint8_t ret;
+
+  if ((_stateKnown & STATE_CONTRAST) && (_contrast == cmd[1]))
+  {
+    return 0;
+  }
+  ret = setCommandList(cmd, sizeof(cmd));
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_CONTRAST;
+    _contrast = cmd[1];
+  }
+  else
+  {
+    _stateKnown &= ~STATE_CONTRAST;
+  }
+  return ret;
 }
 
 /**********************************************************
 Description: invert Display mode
 Parameters: i: True to set invert Display mode (black-on-white).
                False to set normal Display mode (white-on-black).
+Return: 0 : Success (or nothing to send), otherwise the Wire error code of the command.
+Others: Nothing is sent if the panel is already in that mode.
+**********************************************************/
+uint8_t BMD31M090::invertDisplay(bool i)
+{
+  uint8_t ret;
+
+  if ((_stateKnown & STATE_INVERT) && (_inverted == i))
+  {
+    return 0;
+  }
+  ret = setCommand(i ? SET_INVERTDISPLAY : SET_NORMALDISPLAY);
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_INVERT;
+    _inverted = i;
+  }
+  else
+  {
+    _stateKnown &= ~STATE_INVERT;
+  }
+  return ret;
+}
+
+/**********************************************************
+Description: invalidate the cached controller State
+Parameters:
 Return:
-Others:
+Others: The driver mirrors contrast, invert mode, scrolling, addressing mode and the
+        GDDRAM address window/pointer, and skips commands that would not change them.
+        Call this after the panel was reset or reconfigured behind the driver's back
+        (e.g. with setCommandList()); the next calls then send their commands again
+        and the next display() resends the whole frame.
 **********************************************************/
-void BMD31M090::invertDisplay(bool i)
+void BMD31M090::invalidateState(void)
 {
-  setCommand(i ? SET_INVERTDISPLAY : SET_NORMALDISPLAY);
+  displayWait();
+  _stateKnown = 0;
+  markAllDirty();
+  _shadowValid = false;
 }
 
 /**********************************************************
 Description: set Command to display
 Parameters: Commmand: The Command character to send to the display.
-Return:
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
 Others:
 **********************************************************/
-void BMD31M090::setCommand(uint8_t command)
+uint8_t BMD31M090::setCommand(uint8_t command)
 {
-  uint8_t ret;
-  do
-  {
-    _wire->beginTransmission(_deviceAddress);
-    _wire->write(0x00);
-    _wire->write(command);
-    ret = _wire->endTransmission();
-  }while(ret!=0);
+  return sendTransaction(0x00, &command, 1);
 }
 
 /**********************************************************
 Description: set Data to display
 Parameters: Data: The Data character to send to the display.
-Return:
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
 Others:
 **********************************************************/
-void BMD31M090::setData(uint8_t data)
+uint8_t BMD31M090::setData(uint8_t data)
+{
+  return sendTransaction(0x40, &data, 1);
+}
+
+/**********************************************************
+Description: send one I2C transaction to display
+Parameters: control: Control byte, 0x00 for commands or 0x40 for GDDRAM data.
+            data: The bytes following the control byte.
+            len: Number of bytes, up to BMD31M090_DATA_CHUNK.
+Return: 0 : Success, otherwise the Wire error code of the last attempt
+            (2/3 : NACK, 5 : timeout).
+Others: Only an address NACK (2) is repeated, at most _retryMax times and only while
+        the time budget set by setRetryPolicy() is not used up. After a data NACK or
+        a timeout part of the bytes may have reached the panel and moved its GDDRAM
+        pointer, so sending them again would misplace them : the error is returned
+        and the caller re-addresses (see flushData()).
+**********************************************************/
+uint8_t BMD31M090::sendTransaction(uint8_t control, const uint8_t *data, uint8_t len)
 {
   uint8_t ret;
-  do
+  uint8_t retry = 0;
+  uint32_t startTime = micros();
+
+  while (1)
   {
-    _wire->beginTransmission(_deviceAddress);
-    _wire->write(0x40);
-    _wire->write(data);
-    ret = _wire->endTransmission();
-  }while(ret!=0);
+    ret = _bus.write(_deviceAddress, control, data, len);
+    if (ret == 0)
+    {
+      _busStats.bytesSent += len + 1;
+      STATS_ADD(transactions, 1);
+      STATS_ADD(bytesSent, len + 1);
+      if (control == 0x00)
+      {
+        STATS_ADD(commandBytes, len);
+      }
+      else
+      {
+        STATS_ADD(dataBytes, len);
+      }
+      if ((control == 0x40) && (_stateKnown & STATE_WINDOW))
+      {
+        trackPointer(len);
+      }
+      return 0;
+    }
+
+    _stateKnown &= ~STATE_WINDOW;                   // Part of the transaction may have reached the panel
+
+    if ((ret == 2) || (ret == 3))
+    {
+      _busStats.nackCount++;
+    }
+    else if (ret == 5)
+    {
+      _busStats.timeoutCount++;
+    }
+    if ((ret != 2) || (retry >= _retryMax) || ((micros() - startTime) >= _retryTimeout))
+    {
+      _busStats.failCount++;
+      return ret;
+    }
+    retry++;
+    _busStats.retryCount++;
+  }
+}
+
+/**********************************************************
+Description: get instrumentation Statistics
+Parameters:
+Return: Bus traffic counters and the time spent in display(), drawChar(), drawString()
+        and drawBitmap() since the last resetStats().
+Others: Only counted when the library is built with BMD31M090_ENABLE_STATS set to 1,
+        otherwise all fields are 0 and the counters cost neither RAM nor time.
+**********************************************************/
+BMD31M090_Stats BMD31M090::getStats(void)
+{
+#if BMD31M090_ENABLE_STATS
+  return _stats;
+#else
+  BMD31M090_Stats stats;
+  memset(&stats, 0, sizeof(stats));
+  return stats;
+#endif
+}
+
+/**********************************************************
+Description: reset instrumentation Statistics
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BMD31M090::resetStats(void)
+{
+#if BMD31M090_ENABLE_STATS
+  memset(&_stats, 0, sizeof(_stats));
+#endif
 }
 
 /**********************************************************
-Description: set Pow
-Parameters: baseValue : Base Value.
-            indexValue : Index Value.
-Return: The value of baseValue^indexValue.
+Description: set transaction Retry Policy
+Parameters: retryMax : Maximum repeats of a failed transaction (0 : no repeat).
+            timeout : Time budget of one transaction in microseconds, all repeats included.
+                      Also used as the bus timeout of a single attempt.
+Return:
+Others: Defaults : BMD31M090_RETRY_MAX repeats, BMD31M090_RETRY_TIMEOUT us.
+        A transaction that still fails makes the calling function return its error code.
+**********************************************************/
+void BMD31M090::setRetryPolicy(uint8_t retryMax, uint32_t timeout)
+{
+  _retryMax = retryMax;
+  _retryTimeout = timeout;
+  _bus.setTimeout(_retryTimeout);
+}
+
+/**********************************************************
+Description: get Bus Statistics
+Parameters:
+Return: Counters of NACKs, timeouts, retries, failed transactions and bytes sent
+        since begin() or the last clearBusStats().
 Others:
 **********************************************************/
-uint32_t BMD31M090::setPow(uint8_t baseValue, uint8_t indexValue)
+BMD31M090_BusStats BMD31M090::getBusStats(void)
+{
+  return _busStats;
+}
+
+/**********************************************************
+Description: clear Bus Statistics
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BMD31M090::clearBusStats(void)
+{
+  memset(&_busStats, 0, sizeof(_busStats));
+}
+
+/**********************************************************
+Description: swap the Back buffer to the front and send it
+Parameters: callback : Function called from displayPoll() when the transfer completes (optional).
+Return:
+Others: Waits for the previous transfer, then starts an asynchronous transfer of the frame
+        drawn so far (see displayAsync()). With enableDoubleBuffer(), drawing of the next frame
+        can start at once without tearing the frame being sent.
+**********************************************************/
+void BMD31M090::swapBuffers(BMD31M090_Callback callback)
+{
+  displayWait();
+  displayAsync(callback);
+}
+
+/**********************************************************
+Description: enable Double buffering
+Parameters: backBuffer : Caller-owned memory of _displayWidth * ((_displayHeight + 7) / 8) bytes
+                         (1024 bytes for 128 * 64), or NULL to return to a single buffer.
+Return:
+Others: Drawing then goes to the back buffer while a transfer streams the front buffer.
+        swapBuffers() (or display()/displayAsync()) exchanges them and copies the new front
+        buffer into the back buffer, so drawing continues on the latest frame.
+        Without this call no extra memory is used. Ignored in page mode.
+**********************************************************/
+void BMD31M090::enableDoubleBuffer(uint8_t *backBuffer)
+{
+  uint16_t size = _displayWidth * ((_displayHeight + 7) / 8);
+
+  if (_pageMode || (_buffer == NULL))
+  {
+    return;                                         // Page mode streams each page as it is rendered
+  }
+  displayWait();
+  if (_frame != _buffer)
+  {
+    memcpy(_buffer, _frame, size);                  // Latest drawing goes back to the built-in buffer
+  }
+  _frame = _buffer;
+  _sendFrame = _buffer;
+  if (backBuffer)
+  {
+    memcpy(backBuffer, _buffer, size);
+    _frame = backBuffer;
+  }
+}
+
+/**********************************************************
+Description: enable Shadow Frame diffing
+Parameters: shadowBuffer : Caller-owned memory of _displayWidth * ((_displayHeight + 7) / 8) bytes
+                           (1024 bytes for 128 * 64), or NULL to disable diffing.
+Return:
+Others: The shadow keeps a copy of the last frame sent to the panel. display() compares the
+        dirty spans of buffer against it and only sends the bytes that really changed, so
+        clearDisplay() followed by redrawing the same picture costs (almost) nothing.
+        Unchanged gaps up to BMD31M090_READDRESS_COST bytes are sent anyway when that is
+        cheaper than addressing a new window.
+        The next display() sends the full frame to fill the shadow.
+**********************************************************/
+void BMD31M090::enableShadowFrame(uint8_t *shadowBuffer)
+{
+  displayWait();
+  _shadow = shadowBuffer;
+  _shadowValid = false;
+  markAllDirty();
+}
+
+/**********************************************************
+Description: get Saved Bytes
+Parameters:
+Return: Number of dirty GDDRAM bytes the last display() did not need to send.
+Others: Always 0 unless enableShadowFrame() is used.
+**********************************************************/
+uint16_t BMD31M090::getSavedBytes(void)
+{
+  return _savedBytes;
+}
+
+/**********************************************************
+Description: enable Page mode
+Parameters: pageBuffer : Caller-owned memory of _displayWidth bytes (one page,
+                         128 bytes for 128 * 64).
+Return:
+Others: For boards that cannot spare a whole frame buffer. The frame is then rendered
+        by drawPages(), one page at a time, with the usual drawing functions.
+        A frame buffer allocated by the constructor is released; attachBuffer() returns
+        to full-frame mode.
+        BMD31M090_PagePanel<width, height> enables it without ever allocating a frame buffer.
+        Panels sharing this frame buffer (see shareBuffer()) return to their own one.
+**********************************************************/
+void BMD31M090::enablePageMode(uint8_t *pageBuffer)
+{
+  displayWait();
+  shareBuffer(NULL);
+  while (_bufferAlias)
+  {
+    _bufferAlias->shareBuffer(NULL);                // Unlinks itself from this list
+  }
+  if (_ownBuffer)
+  {
+    free(_buffer);
+    _ownBuffer = false;
+  }
+  _buffer = pageBuffer;
+  _frame = pageBuffer;
+  _sendFrame = pageBuffer;
+  _pageMode = true;
+  _pageIndex = 0;
+  _shadow = NULL;
+  _shadowValid = false;
+}
+
+/**********************************************************
+Description: attach a frame Buffer
+Parameters: frameBuffer : Caller-owned memory of _displayWidth * ((_displayHeight + 7) / 8) bytes.
+Return:
+Others: Replaces the frame buffer, e.g. to place it in a specific RAM bank or to switch
+        between screens kept in several buffers. A frame buffer allocated by the
+        constructor is released. Also ends page mode, double buffering and shareBuffer(),
+        and panels sharing the old frame buffer return to their own one.
+        The content of frameBuffer is kept; the next display() sends the whole frame.
+**********************************************************/
+void BMD31M090::attachBuffer(uint8_t *frameBuffer)
+{
+  displayWait();
+  shareBuffer(NULL);
+  while (_bufferAlias)
+  {
+    _bufferAlias->shareBuffer(NULL);
+  }
+  if (_ownBuffer)
+  {
+    free(_buffer);
+    _ownBuffer = false;
+  }
+  _buffer = frameBuffer;
+  _frame = frameBuffer;
+  _sendFrame = frameBuffer;
+  _pageMode = false;
+  markAllDirty();
+}
+
+/**********************************************************
+Description: share the frame Buffer of another instance
+Parameters: source : Instance whose frame buffer this panel shows (mirroring without a copy),
+                     or NULL to return to this instance's own frame buffer.
+Return:
+Others: Draw on source only; every change drawn there is also marked dirty here, so
+        display() on both panels sends the same changes. With double buffering on source,
+        call source's display()/displayAsync() first. Not available in page mode.
+        If source shares another instance's buffer, that instance becomes the source.
+**********************************************************/
+void BMD31M090::shareBuffer(BMD31M090 *source)
+{
+  displayWait();
+  if (_bufferSource)
+  {
+    /* Unlink from the aliases of the current source */
+    BMD31M090 *link = _bufferSource;
+    while (link->_bufferAlias != this)
+    {
+      link = link->_bufferAlias;
+    }
+    link->_bufferAlias = _bufferAlias;
+    _bufferAlias = NULL;
+    _bufferSource = NULL;
+    _frame = _buffer;
+    _sendFrame = _buffer;
+  }
+
+  while (source && source->_bufferSource)
+  {
+    source = source->_bufferSource;                 // Aliases hang off the instance owning the buffer
+  }
+  if (source && (source != this) && !_pageMode && !source->_pageMode)
+  {
+    while (_bufferAlias)
+    {
+      _bufferAlias->shareBuffer(NULL);              // Panels showing this buffer return to their own one
+    }
+    _bufferSource = source;
+    _bufferAlias = source->_bufferAlias;
+    source->_bufferAlias = this;
+    _frame = source->_sendFrame;
+    _sendFrame = source->_sendFrame;
+  }
+  markAllDirty();
+}
+
+/**********************************************************
+Description: draw the frame Page by page (picture loop)
+Parameters: draw : Function drawing the whole frame with drawPixel(), drawLine(), drawChar(),
+                   drawString(), drawBitmap() etc. NULL clears the panel.
+Return: 0 : Success, otherwise the Wire error code of the transaction that failed.
+Others: Page mode only (see enablePageMode()). For each page the page buffer is cleared,
+        draw() is called and the page is sent to the panel at once. Drawing outside the
+        current page is skipped, so draw() runs once per page (8 times for 64 rows) and
+        must draw the same frame each time.
+**********************************************************/
+uint8_t BMD31M090::drawPages(BMD31M090_Callback draw)
+{
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+  uint8_t ret;
+
+  if (!_pageMode)
+  {
+    return 0;
+  }
+
+  ret = setWindow(0, _displayWidth - 1, 0, pageNum - 1);
+  for (_pageIndex = 0; (_pageIndex < pageNum) && (ret == 0); _pageIndex++)
+  {
+    memset(_frame, 0x00, _displayWidth);
+    if (draw)
+    {
+      draw();
+    }
+    ret = setDataList(_frame, _displayWidth);
+  }
+  _pageIndex = 0;
+  return ret;
+}
+
+/**********************************************************
+Description: get the Bus transport
+Parameters:
+Return: The transport object used by this display.
+Others: e.g. to read the recorded traffic of BMD31M090_FakeBus in host builds.
+**********************************************************/
+BMD31M090_Bus &BMD31M090::getBus(void)
+{
+  return _bus;
+}
+
+/**********************************************************
+Description: set Command List to display
+Parameters: cmdList: The Command characters (and their parameters) to send to the display.
+            len: Number of Command characters.
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
+Others: The commands are sent behind a single 0x00 control byte, split into
+        transactions of up to BMD31M090_DATA_CHUNK bytes.
+        They bypass the cached controller state, see invalidateState().
+**********************************************************/
+uint8_t BMD31M090::setCommandList(const uint8_t *cmdList, uint8_t len)
+{
+  uint8_t ret;
+  uint8_t chunk;
+  while (len)
+  {
+    chunk = (len > BMD31M090_DATA_CHUNK) ? BMD31M090_DATA_CHUNK : len;
+    ret = sendTransaction(0x00, cmdList, chunk);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    cmdList += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+/**********************************************************
+Description: set Data List to display
+Parameters: data: The Data characters to send to the display.
+            len: Number of Data characters.
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
+Others: The data is split into transactions of one 0x40 control byte followed by
+        up to BMD31M090_DATA_CHUNK bytes, so that the Wire TX buffer never overflows.
+**********************************************************/
+uint8_t BMD31M090::setDataList(const uint8_t *data, uint16_t len)
+{
+  uint8_t ret;
+  uint8_t chunk;
+  while (len)
+  {
+    chunk = (len > BMD31M090_DATA_CHUNK) ? BMD31M090_DATA_CHUNK : len;
+    ret = sendTransaction(0x40, data, chunk);
+    if (ret != 0)
+    {
+      return ret;
+    }
+    data += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+/**********************************************************
+Description: set GDDRAM address window
+Parameters: x_Start : Start column, 0 at left to (_displayWidth - 1) at right.
+            x_End : End column.
+            page_Start : Start page, 0 at top page to 7 at bottom page.
+            page_End : End page.
+Return: 0 : Success, otherwise the Wire error code of the failed transaction.
+Others: Horizontal addressing mode : the data that follows fills x_Start..x_End
+        of page_Start, then wraps to the next page of the window.
+        The column or page range is only sent if the window or the GDDRAM pointer differ
+        from the cached state; the addressing mode is re-selected after invalidateState().
+**********************************************************/
+uint8_t BMD31M090::setWindow(uint8_t x_Start, uint8_t x_End, uint8_t page_Start, uint8_t page_End)
+{
+  uint8_t cmd[8];
+  uint8_t len = 0;
+  bool windowKnown = (_stateKnown & STATE_WINDOW);
+  uint8_t ret;
+
+  if (!(_stateKnown & STATE_MODE))
+  {
+    cmd[len++] = SET_ADDRESSINGMODE;                // 0x20, Horizontal Address Mode
+    cmd[len++] = 0x00;
+  }
+  if (!windowKnown || (_winColStart != x_Start) || (_winColEnd != x_End) || (_ptrCol != x_Start))
+  {
+    cmd[len++] = SET_COLUMNADDR;                    // 0x21, Column start / end address
+    cmd[len++] = x_Start;
+    cmd[len++] = x_End;
+  }
+  if (!windowKnown || (_winPageStart != page_Start) || (_winPageEnd != page_End) || (_ptrPage != page_Start))
+  {
+    cmd[len++] = SET_PAGEADDR;                      // 0x22, Page start / end address
+    cmd[len++] = page_Start;
+    cmd[len++] = page_End;
+  }
+  if (len == 0)
+  {
+    return 0;                                       // Window and pointer already in place
+  }
+
+  ret = setCommandList(cmd, len);
+  if (ret == 0)
+  {
+    _stateKnown |= STATE_MODE | STATE_WINDOW;
+    _winColStart = x_Start;
+    _winColEnd = x_End;
+    _winPageStart = page_Start;
+    _winPageEnd = page_End;
+    _ptrCol = x_Start;
+    _ptrPage = page_Start;
+  }
+  return ret;
+}
+
+/**********************************************************
+Description: track the GDDRAM pointer
+Parameters: len : Number of data bytes just written.
+Return:
+Others: Horizontal addressing mode : the pointer runs through the columns of the
+        window and wraps to the next page, then back to the first page.
+**********************************************************/
+void BMD31M090::trackPointer(uint8_t len)
+{
+  uint8_t colNum = _winColEnd - _winColStart + 1;
+  uint8_t pageNum = _winPageEnd - _winPageStart + 1;
+  uint16_t col = (_ptrCol - _winColStart) + len;
+
+  _ptrCol = _winColStart + (col % colNum);
+  _ptrPage = _winPageStart + (((_ptrPage - _winPageStart) + (col / colNum)) % pageNum);
+}
+
+/**********************************************************
+Description: find the next span of a page to send
+Parameters: page : Page to search, 0 at top page to 7 at bottom page.
+            x_From : First column to search from.
+            x_Start : Returns the first column of the span.
+            x_End : Returns the last column of the span.
+Return: true if a span was found, false if the page has nothing left to send.
+Others: Searches the dirty spans taken over by the running transfer.
+        Without a valid shadow frame the span is the page's dirty range.
+        With it, the span starts at the first byte that differs from the panel and
+        bridges unchanged gaps no longer than BMD31M090_READDRESS_COST bytes.
+**********************************************************/
+bool BMD31M090::findSpan(uint8_t page, uint8_t x_From, uint8_t &x_Start, uint8_t &x_End)
+{
+  uint8_t dirtyEnd = _flushEnd[page];
+  uint16_t col = (x_From > _flushStart[page]) ? x_From : _flushStart[page];
+
+  if (col > dirtyEnd)
+  {
+    return false;
+  }
+  if (!(_shadow && _shadowValid))
+  {
+    x_Start = col;
+    x_End = dirtyEnd;
+    return true;
+  }
+
+  const uint8_t *frame = &_sendFrame[page * _displayWidth];
+  const uint8_t *shadow = &_shadow[page * _displayWidth];
+  while ((col <= dirtyEnd) && (frame[col] == shadow[col]))
+  {
+    col++;
+  }
+  if (col > dirtyEnd)
+  {
+    return false;
+  }
+
+  uint16_t lastDiff = col;
+  x_Start = col;
+  for (col++; col <= dirtyEnd; col++)
+  {
+    if (frame[col] != shadow[col])
+    {
+      lastDiff = col;
+    }
+    else if ((col - lastDiff) > BMD31M090_READDRESS_COST)
+    {
+      break;                                        // Re-addressing is cheaper than bridging this gap
+    }
+  }
+  x_End = lastDiff;
+  return true;
+}
+
+/**********************************************************
+Description: address the next span of the running transfer
+Parameters:
+Return:
+Others: Skips pages with nothing to send; ends the transfer when no span is left.
+        A page's last span shares its window with identical spans of the following pages.
+**********************************************************/
+void BMD31M090::flushWindow(void)
 {
-  uint32_t result = 1;
-  while(indexValue--)
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+  uint8_t lastPage, x_Start, x_End, nextStart, nextEnd, ret;
+  bool singleSpan = !(_shadow && _shadowValid);     // Without diffing each page has one span only
+
+  while (!findSpan(_flushPage, _flushFrom, x_Start, x_End))
   {
-    result *= baseValue;                            // result = baseValue^indexValue
+    _flushPage++;
+    _flushFrom = 0;
+    if (_flushPage >= pageNum)
+    {
+      flushEnd(0);
+      return;
+    }
   }
 
-  return result;
+  lastPage = _flushPage;
+  if (singleSpan || (x_End == _displayWidth - 1))
+  {
+    while ((lastPage + 1 < pageNum) && findSpan(lastPage + 1, 0, nextStart, nextEnd) &&
+           (nextStart == x_Start) && (nextEnd == x_End))
+    {
+      lastPage++;
+    }
+  }
+
+  ret = setWindow(x_Start, x_End, _flushPage, lastPage);
+  if (ret != 0)
+  {
+    flushEnd(ret);
+    return;
+  }
+
+  _spanOffset = x_Start + _flushPage * _displayWidth;
+  if ((x_End - x_Start + 1) == _displayWidth)
+  {
+    /* Full-width pages are contiguous in buffer */
+    _spanWidth = 0;
+    _spanRows = 1;
+    _spanLeft = (uint16_t)(lastPage - _flushPage + 1) * _displayWidth;
+  }
+  else
+  {
+    _spanWidth = x_End - x_Start + 1;
+    _spanRows = lastPage - _flushPage + 1;
+    _spanLeft = _spanWidth;
+  }
+  _flushPage = lastPage;
+  _flushFrom = x_End + 1;
+  _flushState = FLUSH_DATA;
+}
+
+/**********************************************************
+Description: send one chunk of the current span
+Parameters:
+Return:
+Others: Chunks never cross page rows of a narrow span, since those are not contiguous in buffer.
+        The shadow frame is updated with the bytes sent successfully. After a data
+        NACK or a timeout the rest of the span is re-addressed, at most _retryMax times.
+**********************************************************/
+void BMD31M090::flushData(void)
+{
+  uint8_t chunk = (_spanLeft > BMD31M090_DATA_CHUNK) ? BMD31M090_DATA_CHUNK : _spanLeft;
+
+  uint8_t ret = setDataList(&_sendFrame[_spanOffset], chunk);
+  if (ret != 0)
+  {
+    if ((ret == 2) || (_flushRetry >= _retryMax))
+    {
+      flushEnd(ret);
+      return;
+    }
+    /* Part of the chunk may have landed : re-address the rest of the span from this chunk on */
+    _flushRetry++;
+    _busStats.retryCount++;
+    _flushPage = _spanOffset / _displayWidth;
+    _flushFrom = _spanOffset % _displayWidth;
+    _flushState = FLUSH_WINDOW;
+    return;
+  }
+  _flushRetry = 0;
+  if (_shadow)
+  {
+    memcpy(&_shadow[_spanOffset], &_sendFrame[_spanOffset], chunk);
+  }
+  _flushSentBytes += chunk;
+  _spanOffset += chunk;
+  _spanLeft -= chunk;
+
+  if (_spanLeft == 0)
+  {
+    if (--_spanRows == 0)
+    {
+      _flushState = FLUSH_WINDOW;
+      return;
+    }
+    _spanOffset += _displayWidth - _spanWidth;      // Same columns of the next page
+    _spanLeft = _spanWidth;
+  }
+}
+
+/**********************************************************
+Description: end the running display transfer
+Parameters: status : 0 if the whole frame was sent, otherwise the Wire error code that stopped it.
+Return:
+Others: After a failure the spans of the transfer are marked dirty again, so that the
+        next display() sends them once more. Calls the completion callback in both cases.
+**********************************************************/
+void BMD31M090::flushEnd(uint8_t status)
+{
+  _flushError = status;
+  if (status == 0)
+  {
+    _savedBytes = _flushDirtyBytes - _flushSentBytes;
+    if (_shadow && _flushFull)
+    {
+      _shadowValid = true;
+    }
+  }
+  else
+  {
+    for (uint8_t page = 0; page < ((_displayHeight + 7) / 8); page++)
+    {
+      if (_flushStart[page] <= _flushEnd[page])
+      {
+        markDirty(_flushStart[page], _flushEnd[page], page);
+      }
+    }
+  }
+
+  _flushState = FLUSH_IDLE;
+  if (_flushCallback)
+  {
+    _flushCallback();
+  }
+}
+
+/**********************************************************
+Description: wait for the running display transfer
+Parameters:
+Return:
+Others: Used before commands that move the GDDRAM address pointer.
+**********************************************************/
+void BMD31M090::displayWait(void)
+{
+  while (displayPoll())
+  {
+  }
 }
@@ -10,11 +10,56 @@ Version:          V1.0.3   --  2025-05-29
 
 #include "Arduino.h"
 #include "utility/fontTable.h"  
-#include <Wire.h>
+#include "utility/busTransport.h"
 
 #define BMD31M090_DEVICEADDR0  0x3C     // See Schematic "I2C Addr SEL" for address setting,
 #define BMD31M090_DEVICEADDR1  0x3D     // The I2C address can configure: Addr0:0x3C ; Addr1:0x3D
 #define BMD31M090_CLKFREQ      400000UL
+#define BMD31M090_CLKAUTO      0UL      // begin() probes the fastest stable clock
+#define BMD31M090_CLKMAX       1000000UL  // Fast-mode Plus
+#define BMD31M090_CLKTRIALS    8        // Test bursts per clock step
+
+/* Wire TX buffer size, one byte of each transaction is the control byte     */
+#ifndef BMD31M090_WIRE_BUFFER
+  #if defined(I2C_BUFFER_LENGTH)
+    #define BMD31M090_WIRE_BUFFER  I2C_BUFFER_LENGTH
+  #elif defined(BUFFER_LENGTH)
+    #define BMD31M090_WIRE_BUFFER  BUFFER_LENGTH
+  #else
+    #define BMD31M090_WIRE_BUFFER  32
+  #endif
+#endif
+#define BMD31M090_DATA_CHUNK   (BMD31M090_WIRE_BUFFER - 1)   // Command/GDDRAM bytes per transaction
+#define BMD31M090_MAXPAGES     8                              // 64 rows / 8 rows per page
+#ifndef BMD31M090_RETRY_MAX
+#define BMD31M090_RETRY_MAX      3                            // Default repeats of a failed transaction
+#endif
+#ifndef BMD31M090_RETRY_TIMEOUT
+#define BMD31M090_RETRY_TIMEOUT  25000UL                      // Default time budget of one transaction (us)
+#endif
+/* BMD31M090_ENABLE_STATS adds a member to BMD31M090 : set it as a global build flag
+   (e.g. -DBMD31M090_ENABLE_STATS=1), not with #define in a sketch, so that the sketch
+   and the library see the same class.                                              */
+#ifndef BMD31M090_ENABLE_STATS
+#define BMD31M090_ENABLE_STATS   0                            // 1 : count bus traffic and time the main APIs (see getStats())
+#endif
+#ifndef BMD31M090_TARGET_FPS
+#define BMD31M090_TARGET_FPS     30                           // Default frame rate limit of service()
+#endif
+#ifndef BMD31M090_READDRESS_COST
+#define BMD31M090_READDRESS_COST 10                           // Bus bytes to re-address GDDRAM (window command + new data header)
+#endif
+#define BMD31M090_CLIP_DEPTH     4                            // Nesting levels of pushClip(), fixed : it sizes a member of BMD31M090_Canvas
+#ifndef BMD31M090_FAST_BITMAP
+#define BMD31M090_FAST_BITMAP    1                            // 0 : drawBitmap() uses the per-pixel reference path
+#endif
+#ifndef BMD31M090_WORD_FILL
+#if defined(__AVR__)
+#define BMD31M090_WORD_FILL      0                            // 8-bit core : byte loops are already the fastest
+#else
+#define BMD31M090_WORD_FILL      1                            // 1 : fill spans 32 bits at a time
+#endif
+#endif
 
 #define TRUE                  1
 #define FALSE                 0
@@ -80,44 +125,268 @@ Version:          V1.0.3   --  2025-05-29
 #define SCROLLV_TOP          0x01       // Scroll Vertical Direction : Top
 #define SCROLLV_BOTTOM       0x3F       // Scroll Vertical Direction : Bottom
 
-class BMD31M090
+/* Bytes needed by saveRegion() for columns x_Start..x_End of pages page_Start..page_End */
+#define BMD31M090_REGION_SIZE(x_Start, page_Start, x_End, page_End)  \
+  ((uint16_t)((x_End) - (x_Start) + 1) * ((page_End) - (page_Start) + 1))
+
+typedef void (*BMD31M090_Callback)(void);      // Called when an asynchronous display transfer completes
+
+typedef struct
+{
+  uint32_t nackCount;                           // Address or data NACKs
+  uint32_t timeoutCount;                        // Wire timeouts
+  uint32_t retryCount;                          // Repeated transactions
+  uint32_t failCount;                           // Transactions given up after the retry budget
+  uint32_t bytesSent;                           // Control, command and data bytes acknowledged
+} BMD31M090_BusStats;
+
+typedef struct
+{
+  uint16_t fps;                                 // Frames started during the last full second
+  uint32_t frameCount;                          // Frames started by service()
+  uint32_t coalescedCount;                      // requestDisplay() calls merged into an earlier pending frame
+  uint32_t droppedCount;                        // Frame intervals missed while a request was pending
+} BMD31M090_FrameStats;
+
+typedef struct
+{
+  uint32_t transactions;                        // Transactions acknowledged
+  uint32_t bytesSent;                           // Control, command and data bytes acknowledged
+  uint32_t commandBytes;                        // Command bytes (control bytes excluded)
+  uint32_t dataBytes;                           // GDDRAM bytes (control bytes excluded)
+  uint32_t displayCount;                        // display() calls
+  uint32_t displayTime;                         // Microseconds spent in display()
+  uint32_t drawCharCount;
+  uint32_t drawCharTime;                        // Microseconds spent in drawChar()
+  uint32_t drawStringCount;
+  uint32_t drawStringTime;                      // Microseconds spent in drawString() (its drawChar() calls included)
+  uint32_t drawBitmapCount;
+  uint32_t drawBitmapTime;                      // Microseconds spent in drawBitmap()
+} BMD31M090_Stats;
+
+class BMD31M090;
+
+/* Frame buffer in the panel's page layout and the drawing functions on it.
+   Used as an off-screen canvas (see blit()) and as the base of BMD31M090.    */
+class BMD31M090_Canvas
 {
   public:
-    BMD31M090(uint8_t width, uint8_t height, TwoWire *theWire = &Wire);
-    void begin(uint8_t  i2c_addr = BMD31M090_DEVICEADDR0, uint32_t clkFrequency = BMD31M090_CLKFREQ);
+    BMD31M090_Canvas(uint8_t width, uint8_t height, uint8_t *frameBuffer);
+    virtual ~BMD31M090_Canvas(void);
+    uint8_t width(void);
+    uint8_t height(void);
+    uint8_t *getBuffer(void);
     void clearDisplay(void);
-    void display(void);
     void drawPixel(uint8_t x, uint8_t y, uint8_t pixelColor);
     void drawLine(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t pixelColor);
     void drawFastHLine(uint8_t x, uint8_t y, uint8_t width, uint8_t pixelColor);
     void drawFastVLine(uint8_t x, uint8_t y, uint8_t height, uint8_t pixelColor);
-    void drawChar(uint8_t x, uint8_t row, uint8_t chr);
-    void drawString(uint8_t x, uint8_t row, uint8_t *str);
+    void fillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t pixelColor);
+    void clearRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+    void invertRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+    void drawCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t pixelColor);
+    void fillCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t pixelColor);
+    void drawEllipse(uint8_t x0, uint8_t y0, uint8_t radiusX, uint8_t radiusY, uint8_t pixelColor);
+    void fillEllipse(uint8_t x0, uint8_t y0, uint8_t radiusX, uint8_t radiusY, uint8_t pixelColor);
+    void drawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t pixelColor);
+    void fillRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t pixelColor);
+    void drawTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixelColor);
+    void fillTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixelColor);
+    virtual uint8_t drawChar(uint8_t x, uint8_t row, uint8_t chr);
+    uint8_t drawString(uint8_t x, uint8_t row, uint8_t *str);
     void drawNum(uint8_t x, uint8_t row, uint32_t num, uint8_t numLen);
     void drawBitmap(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor);
-    void startScrollRight(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection = SCROLLV_NONE);
-    void startScrollLeft(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection = SCROLLV_NONE);
-    void stopScroll(void);
+    void blit(BMD31M090_Canvas &canvas, int16_t x, int16_t y);
+    uint16_t saveRegion(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End, uint8_t *store);
+    uint16_t restoreRegion(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End, const uint8_t *store);
     void setFont(const unsigned char* font);
-    void setPixelRow(uint8_t x, uint8_t row);
-    void dim(bool dim);
-    void invertDisplay(bool i);
-    
-  private:
-    void setCommand(uint8_t command);
-    void setData(uint8_t data);
+    bool pushClip(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+    void popClip(void);
+
+  protected:
+    void markDirty(uint8_t x_Start, uint8_t x_End, uint8_t page);
+    void markAllDirty(void);
+    uint8_t *pageRow(uint8_t page);
+    uint8_t clipMask(uint8_t page);
+    void plotPixel(uint8_t x, uint8_t y, uint8_t pixelColor);
+    bool linePoint(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t &x, uint8_t &y);
+    void lineSpan(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t y, int16_t &x_Min, int16_t &x_Max);
+    void drawBitmapPixels(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor);
+    void transposeBlock(uint8_t *block);
+    void fillSpan(uint8_t *row, uint8_t x_Start, uint8_t x_End, uint8_t mask, uint8_t pixelColor);
+    void fillBox(int16_t x_Start, int16_t y_Start, int16_t x_End, int16_t y_End, uint8_t pixelColor);
+    void drawRounded(int16_t x, int16_t y, uint8_t radiusX, uint8_t radiusY, int16_t gapX, int16_t gapY, bool fill, uint8_t pixelColor);
+    bool clipRegion(uint8_t &x_End, uint8_t &page_End);
     uint32_t setPow(uint8_t baseValue, uint8_t indexValue);
-    TwoWire *_wire = NULL;
-    uint8_t _deviceAddress;             // device address initialized when begin method is called
-    uint32_t _clkFrequency;
     uint8_t _displayWidth;
     uint8_t _displayHeight;
-
-    const unsigned char* _font;
+    const unsigned char* _font = NULL;
     uint8_t _fontOffset = 2;
-    uint8_t _fontWidth;
-    uint8_t _fontHeight;
-    uint8_t buffer[1024];
+    uint8_t _fontWidth = 0;
+    uint8_t _fontHeight = 0;
+    uint8_t *_frame;                              // Buffer the drawing functions write to
+    uint8_t _dirtyStart[BMD31M090_MAXPAGES];      // First changed column of each page (> _dirtyEnd : page is clean)
+    uint8_t _dirtyEnd[BMD31M090_MAXPAGES];        // Last changed column of each page
+    BMD31M090 *_bufferAlias = NULL;               // Next panel sharing this frame buffer (gets its dirty spans)
+    bool _pageMode = false;                       // _frame holds one page only, see BMD31M090::drawPages()
+    uint8_t _pageIndex = 0;                       // Page rendered by the running drawPages()
+    uint8_t _clipXStart = 0;                      // Clip rectangle, inclusive (start > end : nothing is drawn)
+    uint8_t _clipYStart = 0;
+    uint8_t _clipXEnd;
+    uint8_t _clipYEnd;
+    uint8_t _clipStack[BMD31M090_CLIP_DEPTH][4];  // Clip rectangles saved by pushClip()
+    uint8_t _clipDepth = 0;
+};
+
+class BMD31M090 : public BMD31M090_Canvas
+{
+  friend class BMD31M090_Group;
+
+  public:
+    BMD31M090(uint8_t width, uint8_t height, BMD31M090_Bus bus = BMD31M090_Bus());
+    BMD31M090(uint8_t width, uint8_t height, uint8_t *frameBuffer, BMD31M090_Bus bus = BMD31M090_Bus());
+    ~BMD31M090(void);
+    BMD31M090(const BMD31M090 &) = delete;                // Owns its frame buffer : not copyable
+    BMD31M090 &operator=(const BMD31M090 &) = delete;
+    uint8_t begin(uint8_t  i2c_addr = BMD31M090_DEVICEADDR0, uint32_t clkFrequency = BMD31M090_CLKFREQ);
+    uint32_t probeClock(uint32_t maxFrequency = BMD31M090_CLKMAX, uint8_t trials = BMD31M090_CLKTRIALS);
+    uint32_t getClock(void);
+    uint8_t display(void);
+    uint8_t display(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End);
+    bool displayAsync(BMD31M090_Callback callback = NULL);
+    bool displayPoll(void);
+    bool displayBusy(void);
+    uint8_t getDisplayStatus(void);
+    void requestDisplay(void);
+    bool service(void);
+    void setTargetFps(uint8_t fps);
+    BMD31M090_FrameStats getFrameStats(void);
+    void clearFrameStats(void);
+    void swapBuffers(BMD31M090_Callback callback = NULL);
+    void enableDoubleBuffer(uint8_t *backBuffer);
+    uint8_t drawChar(uint8_t x, uint8_t row, uint8_t chr);
+    uint8_t drawString(uint8_t x, uint8_t row, uint8_t *str);
+    void drawBitmap(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor);
+    uint8_t startScrollRight(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection = SCROLLV_NONE);
+    uint8_t startScrollLeft(uint8_t startRow, uint8_t endRow, uint8_t scrollSpeed, uint8_t scrollVDirection = SCROLLV_NONE);
+    uint8_t stopScroll(void);
+    uint8_t setPixelRow(uint8_t x, uint8_t row);
+    uint8_t dim(bool dim);
+    uint8_t invertDisplay(bool i);
+    void invalidateState(void);
+    uint8_t setCommandList(const uint8_t *cmdList, uint8_t len);
+    void setRetryPolicy(uint8_t retryMax, uint32_t timeout);
+    BMD31M090_BusStats getBusStats(void);
+    void clearBusStats(void);
+    BMD31M090_Stats getStats(void);
+    void resetStats(void);
+    BMD31M090_Bus &getBus(void);
+    void enableShadowFrame(uint8_t *shadowBuffer);
+    void enablePageMode(uint8_t *pageBuffer);
+    void attachBuffer(uint8_t *frameBuffer);
+    void shareBuffer(BMD31M090 *source);
+    uint8_t drawPages(BMD31M090_Callback draw);
+    uint16_t getSavedBytes(void);
+
+  private:
+    uint8_t setCommand(uint8_t command);
+    uint8_t setData(uint8_t data);
+    uint8_t setDataList(const uint8_t *data, uint16_t len);
+    uint8_t sendTransaction(uint8_t control, const uint8_t *data, uint8_t len);
+    uint8_t setWindow(uint8_t x_Start, uint8_t x_End, uint8_t page_Start, uint8_t page_End);
+    bool findSpan(uint8_t page, uint8_t x_From, uint8_t &x_Start, uint8_t &x_End);
+    void flushBegin(BMD31M090_Callback callback, bool fullFrame);
+    void flushWindow(void);
+    void flushData(void);
+    void flushEnd(uint8_t status);
+    void displayWait(void);
+    void trackPointer(uint8_t len);
+    BMD31M090_Bus _bus;                 // Bus transport, selected at compile time by BMD31M090_BUS
+    uint8_t _deviceAddress;             // device address initialized when begin method is called
+    uint32_t _clkFrequency;
+    uint8_t _retryMax = BMD31M090_RETRY_MAX;
+    uint32_t _retryTimeout = BMD31M090_RETRY_TIMEOUT;
+    BMD31M090_BusStats _busStats = {0, 0, 0, 0, 0};
+
+    /* Mirror of the controller state, to skip commands that change nothing */
+    uint8_t _stateKnown = 0;                      // STATE_* bits of the fields below that match the panel
+    uint8_t _contrast;
+    bool _inverted;
+    bool _scrollActive;
+    uint8_t _winColStart, _winColEnd;             // Address window (horizontal addressing mode)
+    uint8_t _winPageStart, _winPageEnd;
+    uint8_t _ptrCol, _ptrPage;                    // GDDRAM pointer, where the next data byte lands
+
+    uint8_t *_buffer;                             // Built-in frame buffer, _displayWidth * ((_displayHeight + 7) / 8) bytes
+    bool _ownBuffer;                              // _buffer was allocated by the constructor
+    BMD31M090 *_bufferSource = NULL;              // Instance whose frame buffer is shown, see shareBuffer()
+    uint8_t *_sendFrame;                          // Frame the display transfer reads (== _frame unless double-buffered)
+    uint8_t *_shadow = NULL;                      // Last frame sent to the panel (optional, caller-owned)
+    bool _shadowValid = false;                    // _shadow matches the panel GDDRAM
+    uint16_t _savedBytes = 0;                     // GDDRAM bytes skipped by the last display()
+
+    /* Asynchronous display transfer state */
+    uint8_t _flushState = 0;                      // FLUSH_IDLE / FLUSH_WINDOW / FLUSH_DATA
+    uint8_t _flushStart[BMD31M090_MAXPAGES];      // Dirty spans taken over by the running transfer
+    uint8_t _flushEnd[BMD31M090_MAXPAGES];
+    uint8_t _flushPage;                           // Page being searched for the next span
+    uint8_t _flushFrom;                           // Column to search from in _flushPage
+    uint8_t _spanWidth;                           // Bytes per page row of the current span (0 : contiguous)
+    uint8_t _spanRows;                            // Page rows of the current span left to send
+    uint16_t _spanOffset;                         // Next buffer index to send
+    uint16_t _spanLeft;                           // Bytes left in the current page row
+    uint16_t _flushDirtyBytes;
+    uint16_t _flushSentBytes;
+    uint8_t _flushError = 0;                      // Wire error code that stopped the last transfer
+    uint8_t _flushRetry;                          // Re-addressings of the current chunk after a data error
+    bool _flushFull;                              // The transfer covers all changes (not a region)
+    BMD31M090_Callback _flushCallback = NULL;
+
+    /* Frame pacing state of requestDisplay()/service() */
+    uint32_t _frameInterval = 1000000UL / BMD31M090_TARGET_FPS;   // Minimum time between frame starts (us, 0 : no limit)
+    uint32_t _frameTime = 0;                      // Start time of the last frame (us)
+    uint32_t _requestTime;                        // Time of the first request not yet sent (us)
+    bool _framePending = false;
+    uint32_t _fpsTime = 0;                        // Start of the current FPS measuring window (ms)
+    uint16_t _fpsFrames = 0;                      // Frames started in the current window
+    BMD31M090_FrameStats _frameStats = {0, 0, 0, 0};
+
+#if BMD31M090_ENABLE_STATS
+    /* Last, so that the members before it keep their offsets with or without it */
+    BMD31M090_Stats _stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+#endif
+};
+
+/* BMD31M090 with its geometry fixed at compile time and an exactly sized,
+   statically allocated frame buffer, e.g. BMD31M090_Panel<128, 32> (512 bytes)
+   or BMD31M090_Panel<64, 48> (384 bytes). No heap is used.                     */
+template <uint8_t W, uint8_t H>
+class BMD31M090_Panel : public BMD31M090
+{
+  static_assert((W > 0) && (W <= 128) && (H > 0) && (H <= 64), "BMD31M090_Panel : at most 128 x 64 pixels");
+
+  public:
+    BMD31M090_Panel(BMD31M090_Bus bus = BMD31M090_Bus()) : BMD31M090(W, H, _panelBuffer, bus) {}
+
+  private:
+    uint8_t _panelBuffer[W * ((H + 7) / 8)];
+};
+
+/* BMD31M090 in page mode (see drawPages()) with a statically allocated buffer
+   of a single page, e.g. 128 bytes instead of 1024 for BMD31M090_PagePanel<128, 64>. */
+template <uint8_t W, uint8_t H>
+class BMD31M090_PagePanel : public BMD31M090
+{
+  static_assert((W > 0) && (W <= 128) && (H > 0) && (H <= 64), "BMD31M090_PagePanel : at most 128 x 64 pixels");
+
+  public:
+    BMD31M090_PagePanel(BMD31M090_Bus bus = BMD31M090_Bus()) : BMD31M090(W, H, _pageBuffer, bus)
+    {
+      enablePageMode(_pageBuffer);
+    }
+
+  private:
+    uint8_t _pageBuffer[W];
 };
 
 #endif
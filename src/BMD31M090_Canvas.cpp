@@ -0,0 +1,1517 @@
+/*****************************************************************
+File:        BMD31M090_Canvas.cpp
+Author:      BEST MODULES CORP.
+Description: BMD31M090_Canvas.cpp holds the drawing functions shared by the
+             BMD31M090 frame buffer and off-screen canvases
+Version:     V1.0.3   --  2025-05-29
+******************************************************************/
+#include "BMD31M090.h"
+
+#ifndef _swapValue_uint8_t
+#define _swapValue_uint8_t(a, b)                                               \
+  {                                                                            \
+    uint8_t t = a;                                                             \
+    a = b;                                                                     \
+    b = t;                                                                     \
+  }
+#endif
+
+/**********************************************************
+Description: Constructor
+Parameters: width: Canvas width in pixels
+            height: Canvas height in pixels
+            frameBuffer: Caller-owned memory of width * ((height + 7) / 8) bytes,
+                         in the panel's page layout (one byte = 8 vertical pixels, LSB on top).
+Return:
+Others: An off-screen canvas supports the same drawing functions as BMD31M090 and is
+        copied into a frame buffer with blit(). Call setFont() before drawing text.
+        At most BMD31M090_MAXPAGES pages (64 rows) are tracked : a taller height is
+        clamped to 64 and the rows below are never drawn.
+**********************************************************/
+BMD31M090_Canvas::BMD31M090_Canvas(uint8_t width, uint8_t height, uint8_t *frameBuffer)
+{
+  _displayWidth = width;
+  _displayHeight = (height > (BMD31M090_MAXPAGES * 8)) ? (BMD31M090_MAXPAGES * 8) : height;
+  _frame = frameBuffer;
+  _clipXEnd = width - 1;
+  _clipYEnd = _displayHeight - 1;
+  memset(_dirtyStart, 0xFF, sizeof(_dirtyStart));
+  memset(_dirtyEnd, 0x00, sizeof(_dirtyEnd));
+}
+
+/**********************************************************
+Description: Destructor
+Parameters:
+Return:
+Others: Virtual, so a panel deleted through a BMD31M090_Canvas pointer is released fully.
+**********************************************************/
+BMD31M090_Canvas::~BMD31M090_Canvas(void)
+{
+}
+
+/**********************************************************
+Description: get Width
+Parameters:
+Return: Width in pixels.
+Others:
+**********************************************************/
+uint8_t BMD31M090_Canvas::width(void)
+{
+  return _displayWidth;
+}
+
+/**********************************************************
+Description: get Height
+Parameters:
+Return: Height in pixels.
+Others:
+**********************************************************/
+uint8_t BMD31M090_Canvas::height(void)
+{
+  return _displayHeight;
+}
+
+/**********************************************************
+Description: get the Buffer
+Parameters:
+Return: The memory drawn to, in page layout.
+Others:
+**********************************************************/
+uint8_t *BMD31M090_Canvas::getBuffer(void)
+{
+  return _frame;
+}
+
+/**********************************************************
+Description: Clear contents of the buffer
+Parameters:
+Return:
+Others: set all pixels to off, ignoring the clip rectangle (see clearRect()).
+        In page mode only the page being rendered is cleared.
+**********************************************************/
+void BMD31M090_Canvas::clearDisplay(void)
+{
+  if (_frame == NULL)
+  {
+    return;
+  }
+  memset(_frame, 0x00, _pageMode ? _displayWidth : (_displayWidth * ((_displayHeight + 7) / 8)));
+  markAllDirty();
+}
+
+/**********************************************************
+Description: Set/Clear/Invert a single pixel.
+Parameters: x: Column of display, 0 at left to (_displayWidth - 1) at right.
+            y: Row of display, 0 at left to (_displayHeight - 1) at right.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Pixels outside the clip rectangle (by default the buffer) are skipped.
+        In page mode, pixels outside the page being rendered are skipped.
+**********************************************************/
+void BMD31M090_Canvas::drawPixel(uint8_t x, uint8_t y, uint8_t pixelColor)
+{
+  if ((x < _clipXStart) || (x > _clipXEnd) || (y < _clipYStart) || (y > _clipYEnd))
+  {
+    return;
+  }
+  plotPixel(x, y, pixelColor);
+}
+
+/**********************************************************
+Description: draw Line.
+Parameters: x_Start : Start point x coordinate.
+            y_Start : Start point y coordinate.
+            x_End : End point x coordinate.
+            y_End : End point y coordinate.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: The line is clipped once, before the loop : the first and last steps whose
+        pixel lies in the clip rectangle are solved from the error term, so the
+        pixels drawn are exactly those of the unclipped line.
+**********************************************************/
+void BMD31M090_Canvas::drawLine(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t pixelColor)
+{
+  uint8_t Steep = abs(y_End - y_Start) > abs(x_End - x_Start);
+
+  if (Steep)
+  {
+    _swapValue_uint8_t(x_Start, y_Start);
+    _swapValue_uint8_t(x_End, y_End);
+  }
+
+  if (x_Start > x_End)
+  {
+    _swapValue_uint8_t(x_Start, x_End);
+    _swapValue_uint8_t(y_Start, y_End);
+  }
+
+  int16_t dx, dy;
+  dx = x_End - x_Start;
+  dy = abs(y_End - y_Start);
+
+  int8_t yStep;
+
+  if (y_Start < y_End)
+  {
+    yStep = 1;
+  }
+  else
+  {
+    yStep = -1;
+  }
+
+  /* Clip the steps i (0 to dx) along x. The line steps y after step i when
+     i * dy - dx / 2 crosses a multiple of dx, so step i is ceil((i * dy - dx / 2) / dx) rows from y_Start. */
+  int16_t first, last, kFirst, kLast;
+  int32_t num;
+
+  first = (Steep ? _clipYStart : _clipXStart) - x_Start;
+  last = (Steep ? _clipYEnd : _clipXEnd) - x_Start;
+  kFirst = (yStep > 0) ? ((Steep ? _clipXStart : _clipYStart) - y_Start) : (y_Start - (Steep ? _clipXEnd : _clipYEnd));
+  kLast = (yStep > 0) ? ((Steep ? _clipXEnd : _clipYEnd) - y_Start) : (y_Start - (Steep ? _clipXStart : _clipYStart));
+  first = (first < 0) ? 0 : first;
+  last = (last > dx) ? dx : last;
+  kFirst = (kFirst < 0) ? 0 : kFirst;
+  kLast = (kLast > dy) ? dy : kLast;
+  if ((kFirst > kLast) || (pixelColor > pixelColor_INVERSE))
+  {
+    return;
+  }
+  if (dy > 0)
+  {
+    if (kFirst > 0)
+    {
+      num = ((int32_t)(kFirst - 1) * dx + dx / 2) / dy + 1;     // First step kFirst rows away
+      first = (num > first) ? num : first;
+    }
+    num = ((int32_t)kLast * dx + dx / 2) / dy;                  // Last step kLast rows away
+    last = (num < last) ? num : last;
+  }
+  if (first > last)
+  {
+    return;
+  }
+
+  num = (int32_t)first * dy - dx / 2;
+  int16_t k = (num > 0) ? ((num + dx - 1) / dx) : 0;
+  int16_t errValue = dx / 2 - (int32_t)first * dy + (int32_t)k * dx;
+  uint8_t y = y_Start + yStep * k;
+
+  for (int16_t i = x_Start + first; i <= (x_Start + last); i++)
+  {
+    if (Steep)
+    {
+      plotPixel(y, i, pixelColor);
+    }
+    else
+    {
+      plotPixel(i, y, pixelColor);
+    }
+    errValue -= dy;
+    if (errValue < 0)
+    {
+      y += yStep;
+      errValue += dx;
+    }
+  }
+}
+
+/**********************************************************
+Description: draw a Horizontal Line
+Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
+            y: Row of display, 0 at left to (_displayHeight - 1) at right.
+            width : Width of Line, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: A one-row fillBox() : one mask applied to consecutive bytes of its page.
+**********************************************************/
+void BMD31M090_Canvas::drawFastHLine(uint8_t x, uint8_t y, uint8_t width, uint8_t pixelColor)
+{
+  if (width == 0)
+  {
+    return;
+  }
+  fillBox(x, y, (int16_t)x + width - 1, y, pixelColor);
+}
+
+/**********************************************************
+Description: draw a Vertical Line
+Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
+            y: Row of display, 0 at left to (_displayHeight - 1) at right.
+            height : Height of Line, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: A one-column fillRect() : one masked byte per page, so a full-height line
+        on a 64-row panel is 8 byte operations.
+**********************************************************/
+void BMD31M090_Canvas::drawFastVLine(uint8_t x, uint8_t y, uint8_t height, uint8_t pixelColor)
+{
+  fillRect(x, y, 1, height, pixelColor);
+}
+
+/**********************************************************
+Description: fill a Rectangle
+Parameters: x: Column of the left edge, 0 at left to (_displayWidth - 1) at right.
+            y: Row of the top edge, 0 at top to (_displayHeight - 1) at bottom.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Clipped to the clip rectangle. Each page is one fillSpan() with a head
+        mask on the top page, a tail mask on the bottom page and whole bytes in
+        between; the touched spans are marked dirty.
+**********************************************************/
+void BMD31M090_Canvas::fillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t pixelColor)
+{
+  if ((width == 0) || (height == 0))
+  {
+    return;
+  }
+  fillBox(x, y, (int16_t)x + width - 1, (int16_t)y + height - 1, pixelColor);
+}
+
+/**********************************************************
+Description: clear a Rectangle
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+Return:
+Others: Same as fillRect() with pixelColor_BLACK.
+**********************************************************/
+void BMD31M090_Canvas::clearRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+  fillRect(x, y, width, height, pixelColor_BLACK);
+}
+
+/**********************************************************
+Description: invert a Rectangle
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+Return:
+Others: Same as fillRect() with pixelColor_INVERSE, e.g. to highlight a menu item.
+**********************************************************/
+void BMD31M090_Canvas::invertRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+  fillRect(x, y, width, height, pixelColor_INVERSE);
+}
+
+/**********************************************************
+Description: draw Circle
+Parameters: x0: Column of the center.
+            y0: Row of the center.
+            radius : Radius in pixels (up to 127).
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::drawCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t pixelColor)
+{
+  drawEllipse(x0, y0, radius, radius, pixelColor);
+}
+
+/**********************************************************
+Description: fill Circle
+Parameters: x0: Column of the center.
+            y0: Row of the center.
+            radius : Radius in pixels (up to 127).
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::fillCircle(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t pixelColor)
+{
+  fillEllipse(x0, y0, radius, radius, pixelColor);
+}
+
+/**********************************************************
+Description: draw Ellipse
+Parameters: x0: Column of the center.
+            y0: Row of the center.
+            radiusX : Horizontal radius in pixels (up to 127).
+            radiusY : Vertical radius in pixels (up to 127).
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::drawEllipse(uint8_t x0, uint8_t y0, uint8_t radiusX, uint8_t radiusY, uint8_t pixelColor)
+{
+  radiusX = (radiusX > 127) ? 127 : radiusX;
+  radiusY = (radiusY > 127) ? 127 : radiusY;
+  drawRounded((int16_t)x0 - radiusX, (int16_t)y0 - radiusY, radiusX, radiusY, 0, 0, false, pixelColor);
+}
+
+/**********************************************************
+Description: fill Ellipse
+Parameters: x0: Column of the center.
+            y0: Row of the center.
+            radiusX : Horizontal radius in pixels (up to 127).
+            radiusY : Vertical radius in pixels (up to 127).
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::fillEllipse(uint8_t x0, uint8_t y0, uint8_t radiusX, uint8_t radiusY, uint8_t pixelColor)
+{
+  radiusX = (radiusX > 127) ? 127 : radiusX;
+  radiusY = (radiusY > 127) ? 127 : radiusY;
+  drawRounded((int16_t)x0 - radiusX, (int16_t)y0 - radiusY, radiusX, radiusY, 0, 0, true, pixelColor);
+}
+
+/**********************************************************
+Description: draw Round Rectangle
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+            radius : Corner radius, limited to half of the smaller side.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::drawRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t pixelColor)
+{
+  if ((width == 0) || (height == 0))
+  {
+    return;
+  }
+  radius = (radius > ((width - 1) / 2)) ? ((width - 1) / 2) : radius;
+  radius = (radius > ((height - 1) / 2)) ? ((height - 1) / 2) : radius;
+  drawRounded(x, y, radius, radius, width - 1 - 2 * radius, height - 1 - 2 * radius, false, pixelColor);
+}
+
+/**********************************************************
+Description: fill Round Rectangle
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+            radius : Corner radius, limited to half of the smaller side.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Parts outside the buffer are clipped.
+**********************************************************/
+void BMD31M090_Canvas::fillRoundRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t radius, uint8_t pixelColor)
+{
+  if ((width == 0) || (height == 0))
+  {
+    return;
+  }
+  radius = (radius > ((width - 1) / 2)) ? ((width - 1) / 2) : radius;
+  radius = (radius > ((height - 1) / 2)) ? ((height - 1) / 2) : radius;
+  drawRounded(x, y, radius, radius, width - 1 - 2 * radius, height - 1 - 2 * radius, true, pixelColor);
+}
+
+/**********************************************************
+Description: draw Triangle
+Parameters: x0, y0 : First corner.
+            x1, y1 : Second corner.
+            x2, y2 : Third corner.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Three drawLine() calls. With pixelColor_INVERSE the edges are walked pixel by pixel
+        and pixels already drawn by an earlier edge (the corners, and the rows next to a
+        sharp corner) are skipped, so every outline pixel is inverted exactly once.
+**********************************************************/
+void BMD31M090_Canvas::drawTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixelColor)
+{
+  const uint8_t corner[4][2] = {{x0, y0}, {x1, y1}, {x2, y2}, {x0, y0}};
+
+  if (pixelColor != pixelColor_INVERSE)
+  {
+    drawLine(x0, y0, x1, y1, pixelColor);
+    drawLine(x1, y1, x2, y2, pixelColor);
+    drawLine(x2, y2, x0, y0, pixelColor);
+    return;
+  }
+
+  for (uint8_t edge = 0; edge < 3; edge++)
+  {
+    const uint8_t *a = corner[edge];
+    const uint8_t *b = corner[edge + 1];
+    uint8_t Steep = abs(b[1] - a[1]) > abs(b[0] - a[0]);
+    uint8_t from = Steep ? ((a[1] < b[1]) ? a[1] : b[1]) : ((a[0] < b[0]) ? a[0] : b[0]);
+    uint8_t to = Steep ? ((a[1] < b[1]) ? b[1] : a[1]) : ((a[0] < b[0]) ? b[0] : a[0]);
+
+    for (uint16_t step = from; step <= to; step++)
+    {
+      uint8_t x = step, y = step;                   // linePoint() replaces the minor coordinate
+      bool drawn = false;
+
+      linePoint(a[0], a[1], b[0], b[1], x, y);
+      for (uint8_t prev = 0; (prev < edge) && !drawn; prev++)
+      {
+        uint8_t px = x, py = y;
+        drawn = linePoint(corner[prev][0], corner[prev][1], corner[prev + 1][0], corner[prev + 1][1], px, py) &&
+                (px == x) && (py == y);
+      }
+      if (!drawn)
+      {
+        drawPixel(x, y, pixelColor_INVERSE);
+      }
+    }
+  }
+}
+
+/**********************************************************
+Description: fill Triangle
+Parameters: x0, y0 : First corner.
+            x1, y1 : Second corner.
+            x2, y2 : Third corner.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Scanline fill : the rows are clipped to the clip rectangle once, then each row is
+        one span between the pixels drawLine() puts in that row for the long edge
+        (corner 0 to 2, sorted by y) and the short edge it faces, so the fill covers
+        drawTriangle()'s outline exactly. Every pixel is written once, so
+        pixelColor_INVERSE works.
+**********************************************************/
+void BMD31M090_Canvas::fillTriangle(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t pixelColor)
+{
+  int16_t xa, xb, y_Start, y_End;
+
+  /* Sort the corners by row : y0 <= y1 <= y2 */
+  if (y0 > y1)
+  {
+    _swapValue_uint8_t(x0, x1);
+    _swapValue_uint8_t(y0, y1);
+  }
+  if (y1 > y2)
+  {
+    _swapValue_uint8_t(x1, x2);
+    _swapValue_uint8_t(y1, y2);
+  }
+  if (y0 > y1)
+  {
+    _swapValue_uint8_t(x0, x1);
+    _swapValue_uint8_t(y0, y1);
+  }
+
+  y_Start = (y0 > _clipYStart) ? y0 : _clipYStart;
+  y_End = (y2 < _clipYEnd) ? y2 : _clipYEnd;
+  for (int16_t y = y_Start; y <= y_End; y++)
+  {
+    xa = 0x7FFF;
+    xb = -1;
+    lineSpan(x0, y0, x2, y2, y, xa, xb);            // The long edge has pixels in every row
+    if (y <= y1)
+    {
+      lineSpan(x0, y0, x1, y1, y, xa, xb);
+    }
+    if (y >= y1)
+    {
+      lineSpan(x1, y1, x2, y2, y, xa, xb);
+    }
+    fillBox(xa, y, xb, y, pixelColor);
+  }
+}
+
+/**********************************************************
+Description: draw Char
+Parameters: x: Column, 0 at left to (_displayWidth - 1) at right.
+            row: Row page, 0 at top page to 7 at bottom page.
+            chr : The char on FontTable.
+Return: 0 (nothing is sent, see BMD31M090::drawChar()).
+Others: The glyph overwrites the buffer, clipped to the clip rectangle.
+**********************************************************/
+uint8_t BMD31M090_Canvas::drawChar(uint8_t x, uint8_t row, uint8_t chr)
+{
+  uint8_t charPageNum, x_First, x_Last, mask;
+  uint8_t *pageData;
+  const unsigned char *glyph;
+
+  if (_font == NULL)
+  {
+    return 0;
+  }
+  if(x > (_displayWidth-1))
+  {
+    x = 0;
+    row = row + (_fontHeight/8);
+  }
+  if(chr < 32 || chr > 127)
+  {
+    chr = ' ';
+  }
+
+  /* Calculate how many pages a char need. The height is not a multiple of 8 (1 page), set page + 1. */
+  charPageNum = (_fontHeight % 8) ? ((_fontHeight / 8) + 1) : (_fontHeight / 8);
+  glyph = &_font[_fontOffset + (chr - 32) * (_fontWidth * charPageNum)];
+  x_First = (x > _clipXStart) ? x : _clipXStart;
+  x_Last = ((x + _fontWidth - 1) < _clipXEnd) ? (x + _fontWidth - 1) : _clipXEnd;
+  if (x_First > x_Last)
+  {
+    return 0;
+  }
+
+  for (uint8_t pageAddr = 0; (pageAddr < charPageNum) && ((row + pageAddr) < BMD31M090_MAXPAGES); pageAddr++)
+  {
+    mask = clipMask(row + pageAddr);                // Rows of this page inside the clip rectangle
+    pageData = pageRow(row + pageAddr);
+    if ((mask == 0) || (pageData == NULL))
+    {
+      continue;                                     // Clipped, or page mode : not the page being rendered
+    }
+    for (uint8_t i = x_First; i <= x_Last; i++)
+    {
+      pageData[i] = (pageData[i] & ~mask) | (pgm_read_byte(&glyph[(i - x) + (_fontWidth * pageAddr)]) & mask);
+    }
+    markDirty(x_First, x_Last, row + pageAddr);
+  }
+  return 0;
+}
+
+/**********************************************************
+Description: draw String
+Parameters: x: Column, 0 at left to (_displayWidth - 1) at right.
+            row: Row page, 0 at top page to 7 at bottom page.
+            str : The string on FontTable.
+Return: 0 : Success, otherwise the first error returned by drawChar().
+Others: Wraps to the next text row at the right edge.
+**********************************************************/
+uint8_t BMD31M090_Canvas::drawString(uint8_t x, uint8_t row, uint8_t *str)
+{
+  unsigned char j=0;
+  uint8_t ret = 0, status;
+  while (str[j] != '\0')
+  {
+    status = drawChar(x, row, str[j]);
+    ret = ret ? ret : status;
+
+    /* If it is judged that it exceeds the width of the display, set x = 0 and skip to the next display page */
+    x += _fontWidth;
+    if(x > (_displayWidth - _fontWidth))
+    {
+      x = 0;
+      row += (_fontHeight % 8) ? ((_fontHeight / 8) + 1) : (_fontHeight / 8);
+    }
+    j++;
+  }
+  return ret;
+}
+
+/**********************************************************
+Description: draw Num
+Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
+            page: Row page of display, 0 at top page to 7 at bottom page.
+            num : The num on FontTable.
+            numLen : The num Length.
+Return:
+Others:
+**********************************************************/
+void BMD31M090_Canvas::drawNum(uint8_t x, uint8_t row,uint32_t num, uint8_t numLen)
+{
+  uint8_t t,temp;
+  uint8_t enShow=0;
+  for(t=0; t<numLen; t++)
+  {
+    /* One-digit, one-digit display                                                            */
+    temp=(num / setPow(10, (numLen - t - 1))) % 10;
+
+    if(enShow == 0 && t < (numLen - 1))
+    {
+      /* According the value of 'numLen',
+         If the Highest digit number is 0 (or Highest and the second of topest, etc.), then show "space". */
+      if(temp == 0)
+      {
+        drawChar(x + (_fontWidth * t), row, ' ');
+        continue;
+      }
+      else
+      {
+        enShow = 1; 
+      }
+    }
+    /* Show the num                                                                            */
+    drawChar(x + (_fontWidth * t), row, (temp + '0'));
+  }
+}
+
+/**********************************************************
+Description: draw BMP
+Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
+            y: Row of display, 0 at left to (_displayHeight - 1) at right.
+            Bitmap[]: Bitmap Name.
+            w: Width of Bitmap in pixels
+            h: Height of Bitmap in pixels
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: The bitmap is horizontal, MSB first (Image2LCD / LCD Assistant). Each block of
+        8 x 8 pixels is transposed into 8 page-layout bytes with transposeBlock()
+        and merged into the two pages it straddles (a shift when y is not a
+        multiple of 8); x needs no shift, columns are separate bytes.
+        pixelColor_INVERSE inverts the whole rectangle, as the per-pixel path does.
+        Clipped to the clip rectangle once per block row.
+**********************************************************/
+void BMD31M090_Canvas::drawBitmap(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor)
+{
+#if BMD31M090_FAST_BITMAP
+  int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+  int16_t iFirst = _clipXStart - x, iLast = _clipXEnd - x;
+  int16_t pageBase = (y >= 0) ? (y / 8) : -((7 - y) / 8);   // Page holding the bitmap's top row (floor)
+  uint8_t shift = y - pageBase * 8;
+  uint8_t invert = (pixelColor == pixelColor_BLACK) ? 0xFF : 0x00;
+  uint8_t block[8];
+
+  if ((w == 0) || (h == 0))
+  {
+    return;
+  }
+  if ((pixelColor != pixelColor_WHITE) && (pixelColor != pixelColor_BLACK))
+  {
+    fillBox(x, y, x + w - 1, y + h - 1, pixelColor_INVERSE);
+    return;
+  }
+  iFirst = (iFirst < 0) ? 0 : iFirst;
+  iLast = (iLast >= w) ? (w - 1) : iLast;
+  if (iFirst > iLast)
+  {
+    return;
+  }
+
+  for (int16_t j = 0; j < h; j += 8)
+  {
+    int16_t page = pageBase + j / 8;
+    uint8_t rows = ((h - j) >= 8) ? 0xFF : ((1 << (h - j)) - 1);   // Bitmap rows held by this block row
+    uint8_t lowMask = 0, highMask = 0;
+    uint8_t *low = NULL, *high = NULL;
+
+    /* Rows of the block landing in page (shifted down) and in the next page */
+    if ((page >= 0) && (page < BMD31M090_MAXPAGES) && ((low = pageRow(page)) != NULL))
+    {
+      lowMask = (rows << shift) & clipMask(page);
+    }
+    if (shift && ((page + 1) >= 0) && ((page + 1) < BMD31M090_MAXPAGES) && ((high = pageRow(page + 1)) != NULL))
+    {
+      highMask = (rows >> (8 - shift)) & clipMask(page + 1);
+    }
+    if ((lowMask == 0) && (highMask == 0))
+    {
+      continue;
+    }
+
+    for (int16_t i = iFirst & ~7; i <= iLast; i += 8)
+    {
+      for (uint8_t r = 0; r < 8; r++)
+      {
+        if ((j + r) >= h)
+        {
+          block[r] = 0;
+          continue;
+        }
+        #if 1
+        /* RAM-resident 1-bit image at the specified */
+        block[r] = Bitmap[((j + r) * byteWidth) + (i / 8)];
+        #else
+        /* PROGMEM-resident 1-bit image at the specified */
+        block[r] = pgm_read_byte(&Bitmap[((j + r) * byteWidth) + (i / 8)]);
+        #endif
+      }
+      transposeBlock(block);                        // block[c] : column i + c, bit 0 = top row
+
+      uint8_t cFirst = (i < iFirst) ? (iFirst - i) : 0;
+      uint8_t cLast = ((i + 7) > iLast) ? (iLast - i) : 7;
+      for (uint8_t c = cFirst; c <= cLast; c++)
+      {
+        uint8_t col = x + i + c;
+        uint8_t v = block[c] ^ invert;
+        if (lowMask)
+        {
+          low[col] = (low[col] & ~lowMask) | ((v << shift) & lowMask);
+        }
+        if (highMask)
+        {
+          high[col] = (high[col] & ~highMask) | ((v >> (8 - shift)) & highMask);
+        }
+      }
+    }
+    if (lowMask)
+    {
+      markDirty(x + iFirst, x + iLast, page);
+    }
+    if (highMask)
+    {
+      markDirty(x + iFirst, x + iLast, page + 1);
+    }
+  }
+#else
+  drawBitmapPixels(x, y, Bitmap, w, h, pixelColor);
+#endif
+}
+
+/**********************************************************
+Description: draw BMP pixel by pixel
+Parameters: x: Column of display, 0 at left to (_display_width - 1) at right.
+            y: Row of display, 0 at left to (_displayHeight - 1) at right.
+            Bitmap[]: Bitmap Name.
+            w: Width of Bitmap in pixels
+            h: Height of Bitmap in pixels
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Per-pixel reference of drawBitmap(), used when BMD31M090_FAST_BITMAP is 0.
+        The rows and columns inside the clip rectangle are found once, before the loops.
+**********************************************************/
+void BMD31M090_Canvas::drawBitmapPixels(int8_t x, int8_t y, const uint8_t *Bitmap, uint8_t w, uint8_t h, uint8_t pixelColor)
+{
+  int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+  int16_t iFirst = _clipXStart - x, iLast = _clipXEnd - x;
+  int16_t jFirst = _clipYStart - y, jLast = _clipYEnd - y;
+  uint8_t onColor = (pixelColor == pixelColor_WHITE) ? pixelColor_WHITE :
+                                                       (pixelColor == pixelColor_BLACK) ? pixelColor_BLACK : pixelColor_INVERSE;
+  uint8_t offColor = (pixelColor == pixelColor_WHITE) ? pixelColor_BLACK :
+                                                        (pixelColor == pixelColor_BLACK) ? pixelColor_WHITE : pixelColor_INVERSE;
+  uint8_t b;
+
+  iFirst = (iFirst < 0) ? 0 : iFirst;
+  jFirst = (jFirst < 0) ? 0 : jFirst;
+  iLast = (iLast >= w) ? (w - 1) : iLast;
+  jLast = (jLast >= h) ? (h - 1) : jLast;
+  for (int16_t j = jFirst; j <= jLast; j++)
+  {
+    for (int16_t i = iFirst; i <= iLast; i++)
+    {
+      #if 1
+      /* RAM-resident 1-bit image at the specified */
+      b = Bitmap[(j * byteWidth) + (i / 8)];
+      #else
+      /* PROGMEM-resident 1-bit image at the specified */
+      b = pgm_read_byte(&Bitmap[(j * byteWidth) + (i / 8)]);
+      #endif
+      plotPixel(x + i, y + j, ((b << (i & 7)) & 0x80) ? onColor : offColor);
+    }
+  }
+}
+
+/**********************************************************
+Description: blit a canvas
+Parameters: canvas : Off-screen canvas to copy.
+            x : Column of the canvas' left edge (may be negative or clip at the right).
+            y : Row of the canvas' top edge (may be negative or clip at the bottom).
+Return:
+Others: Copies the canvas opaquely, black pixels included, inside the clip rectangle. When y is a multiple of 8
+        whole bytes are copied (memcpy for full pages); otherwise each canvas byte is
+        shifted and merged into the two pages it straddles.
+**********************************************************/
+void BMD31M090_Canvas::blit(BMD31M090_Canvas &canvas, int16_t x, int16_t y)
+{
+  int16_t x_Start = (x < _clipXStart) ? _clipXStart : x;
+  int16_t x_End = ((x + canvas._displayWidth - 1) > _clipXEnd) ? _clipXEnd : (x + canvas._displayWidth - 1);
+  int16_t pageBase = (y >= 0) ? (y / 8) : -((7 - y) / 8);   // Page holding the canvas' top row (floor)
+  uint8_t shift = y - pageBase * 8;
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+  uint8_t srcPageNum = (canvas._displayHeight + 7) / 8;
+  uint8_t len;
+
+  if ((x_Start > x_End) || (canvas._frame == NULL))
+  {
+    return;
+  }
+  len = x_End - x_Start + 1;
+
+  for (uint8_t srcPage = 0; srcPage < srcPageNum; srcPage++)
+  {
+    const uint8_t *src = &canvas._frame[srcPage * canvas._displayWidth + (x_Start - x)];
+    uint8_t rows = canvas._displayHeight - srcPage * 8;
+    uint8_t mask = (rows >= 8) ? 0xFF : ((1 << rows) - 1);   // Canvas rows held by this byte row
+    int16_t page = pageBase + srcPage;
+    uint8_t *dst;
+
+    /* Upper part : lands in page, shifted down by shift rows */
+    if ((page >= 0) && (page < pageNum) && ((dst = pageRow(page)) != NULL))
+    {
+      uint8_t lowMask = (mask << shift) & clipMask(page);
+      if (lowMask == 0xFF)
+      {
+        memcpy(&dst[x_Start], src, len);            // Page-aligned full page : whole-byte copy
+      }
+      else
+      {
+        for (uint8_t i = 0; i < len; i++)
+        {
+          dst[x_Start + i] = (dst[x_Start + i] & ~lowMask) | ((src[i] << shift) & lowMask);
+        }
+      }
+      markDirty(x_Start, x_End, page);
+    }
+
+    /* Lower part : the rows shifted out of the byte land in the next page */
+    page++;
+    if (shift && (page >= 0) && (page < pageNum) && ((dst = pageRow(page)) != NULL))
+    {
+      uint8_t highMask = (mask >> (8 - shift)) & clipMask(page);
+      if (highMask)
+      {
+        for (uint8_t i = 0; i < len; i++)
+        {
+          dst[x_Start + i] = (dst[x_Start + i] & ~highMask) | ((src[i] >> (8 - shift)) & highMask);
+        }
+        markDirty(x_Start, x_End, page);
+      }
+    }
+  }
+}
+
+/**********************************************************
+Description: save a Region of the buffer
+Parameters: x_Start : First column, 0 at left to (_displayWidth - 1) at right.
+            page_Start : First page, 0 at top page to 7 at bottom page.
+            x_End : Last column.
+            page_End : Last page.
+            store : Caller-owned memory of BMD31M090_REGION_SIZE(x_Start, page_Start, x_End, page_End) bytes.
+Return: Number of bytes saved (0 if the region is outside the buffer).
+Others: E.g. the area under a pop-up, put back with restoreRegion() when it closes.
+        Each page row of the region is one memcpy(); the region is clipped to the buffer.
+**********************************************************/
+uint16_t BMD31M090_Canvas::saveRegion(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End, uint8_t *store)
+{
+  uint8_t len;
+  uint8_t *pageData;
+
+  if (!clipRegion(x_End, page_End) || (x_Start > x_End) || (page_Start > page_End))
+  {
+    return 0;
+  }
+
+  len = x_End - x_Start + 1;
+  for (uint8_t page = page_Start; page <= page_End; page++, store += len)
+  {
+    pageData = pageRow(page);
+    if (pageData)
+    {
+      memcpy(store, &pageData[x_Start], len);
+    }
+  }
+  return BMD31M090_REGION_SIZE(x_Start, page_Start, x_End, page_End);
+}
+
+/**********************************************************
+Description: restore a Region of the buffer
+Parameters: x_Start : First column, 0 at left to (_displayWidth - 1) at right.
+            page_Start : First page, 0 at top page to 7 at bottom page.
+            x_End : Last column.
+            page_End : Last page.
+            store : Memory filled by saveRegion() with the same region.
+Return: Number of bytes restored (0 if the region is outside the buffer).
+Others: The region is marked dirty, so the next display() only sends these spans.
+**********************************************************/
+uint16_t BMD31M090_Canvas::restoreRegion(uint8_t x_Start, uint8_t page_Start, uint8_t x_End, uint8_t page_End, const uint8_t *store)
+{
+  uint8_t len;
+  uint8_t *pageData;
+
+  if (!clipRegion(x_End, page_End) || (x_Start > x_End) || (page_Start > page_End))
+  {
+    return 0;
+  }
+
+  len = x_End - x_Start + 1;
+  for (uint8_t page = page_Start; page <= page_End; page++, store += len)
+  {
+    pageData = pageRow(page);
+    if (pageData)
+    {
+      memcpy(&pageData[x_Start], store, len);
+      markDirty(x_Start, x_End, page);
+    }
+  }
+  return BMD31M090_REGION_SIZE(x_Start, page_Start, x_End, page_End);
+}
+
+/**********************************************************
+Description: clip a Region to the buffer
+Parameters: x_End : Last column, lowered to (_displayWidth - 1) if beyond.
+            page_End : Last page, lowered to the last page if beyond.
+Return: false if the buffer is empty.
+Others:
+**********************************************************/
+bool BMD31M090_Canvas::clipRegion(uint8_t &x_End, uint8_t &page_End)
+{
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+
+  if ((_displayWidth == 0) || (pageNum == 0))
+  {
+    return false;
+  }
+  if (x_End >= _displayWidth)
+  {
+    x_End = _displayWidth - 1;
+  }
+  if (page_End >= pageNum)
+  {
+    page_End = pageNum - 1;
+  }
+  return true;
+}
+
+/**********************************************************
+Description: push a Clip rectangle
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+Return: true : Success, false : BMD31M090_CLIP_DEPTH rectangles are already pushed (clip unchanged).
+Others: Until the matching popClip(), every drawing function only changes pixels
+        inside both this rectangle and the previous clip rectangle, e.g. to confine
+        a UI panel to its area. Call popClip() only after a successful pushClip().
+**********************************************************/
+bool BMD31M090_Canvas::pushClip(uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+  int16_t x_End = (int16_t)x + width - 1;
+  int16_t y_End = (int16_t)y + height - 1;
+
+  if (_clipDepth >= BMD31M090_CLIP_DEPTH)
+  {
+    return false;
+  }
+  _clipStack[_clipDepth][0] = _clipXStart;
+  _clipStack[_clipDepth][1] = _clipYStart;
+  _clipStack[_clipDepth][2] = _clipXEnd;
+  _clipStack[_clipDepth][3] = _clipYEnd;
+  _clipDepth++;
+
+  _clipXStart = (x > _clipXStart) ? x : _clipXStart;
+  _clipYStart = (y > _clipYStart) ? y : _clipYStart;
+  _clipXEnd = (x_End < _clipXEnd) ? x_End : _clipXEnd;
+  _clipYEnd = (y_End < _clipYEnd) ? y_End : _clipYEnd;
+  if ((x_End < _clipXStart) || (y_End < _clipYStart))
+  {
+    _clipXStart = 1;                                // Empty (also width or height 0) : nothing is drawn
+    _clipXEnd = 0;
+  }
+  return true;
+}
+
+/**********************************************************
+Description: pop the Clip rectangle
+Parameters:
+Return:
+Others: Restores the clip rectangle of before the last pushClip().
+        Without any pushed rectangle the clip is the whole buffer.
+**********************************************************/
+void BMD31M090_Canvas::popClip(void)
+{
+  if (_clipDepth == 0)
+  {
+    return;
+  }
+  _clipDepth--;
+  _clipXStart = _clipStack[_clipDepth][0];
+  _clipYStart = _clipStack[_clipDepth][1];
+  _clipXEnd = _clipStack[_clipDepth][2];
+  _clipYEnd = _clipStack[_clipDepth][3];
+}
+
+/**********************************************************
+Description: set Font
+Parameters: font: fontTable's font name.
+Return:
+Others: Currently support FontTable_8X16 and FontTable_6X8.
+        After begin() is executed, FontTable_8X16 is used by default.
+        (set __fontWidth and _fontHeight by _font[0]&[1])
+**********************************************************/
+void BMD31M090_Canvas::setFont(const unsigned char* font)
+{
+  _font = font;
+  _fontWidth = pgm_read_byte(&_font[0]);
+  _fontHeight = pgm_read_byte(&_font[1]);
+}
+
+/**********************************************************
+Description: get the buffer Row of a page
+Parameters: page : Page, 0 at top page to 7 at bottom page.
+Return: Pointer to column 0 of the page in _frame, or NULL in page mode if
+        the page is not the one being rendered.
+Others: NULL as well without a frame buffer (allocation failed), so drawing is skipped.
+**********************************************************/
+uint8_t *BMD31M090_Canvas::pageRow(uint8_t page)
+{
+  if (_frame == NULL)
+  {
+    return NULL;
+  }
+  if (_pageMode)
+  {
+    return (page == _pageIndex) ? _frame : NULL;
+  }
+  return &_frame[page * _displayWidth];
+}
+
+/**********************************************************
+Description: get the Clip mask of a page
+Parameters: page : Page, 0 at top page to 7 at bottom page.
+Return: Rows of the page inside the clip rectangle (bit 0 : top row), 0 if none.
+Others:
+**********************************************************/
+uint8_t BMD31M090_Canvas::clipMask(uint8_t page)
+{
+  uint8_t mask = 0xFF;
+  int16_t top = page * 8;
+
+  if ((_clipXStart > _clipXEnd) || (_clipYStart > (top + 7)) || (_clipYEnd < top))
+  {
+    return 0;
+  }
+  if (_clipYStart > top)
+  {
+    mask &= 0xFF << (_clipYStart - top);
+  }
+  if (_clipYEnd < (top + 7))
+  {
+    mask &= 0xFF >> ((top + 7) - _clipYEnd);
+  }
+  return mask;
+}
+
+/**********************************************************
+Description: get the Point of a line at a column (or row)
+Parameters: x_Start, y_Start, x_End, y_End : The line, as given to drawLine().
+            x, y : Point; the coordinate along the line's major axis (x, or y for
+                   a steep line) selects the step, the other one is replaced.
+Return: true if the step lies on the line, false otherwise (x, y unchanged).
+Others: Same rounding as drawLine(), so the point is exactly the pixel it draws.
+**********************************************************/
+bool BMD31M090_Canvas::linePoint(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t &x, uint8_t &y)
+{
+  uint8_t Steep = abs(y_End - y_Start) > abs(x_End - x_Start);
+  uint8_t major = Steep ? y : x;
+
+  if (Steep)
+  {
+    _swapValue_uint8_t(x_Start, y_Start);
+    _swapValue_uint8_t(x_End, y_End);
+  }
+  if (x_Start > x_End)
+  {
+    _swapValue_uint8_t(x_Start, x_End);
+    _swapValue_uint8_t(y_Start, y_End);
+  }
+  if ((major < x_Start) || (major > x_End))
+  {
+    return false;
+  }
+
+  int16_t dx = x_End - x_Start;
+  int16_t dy = abs(y_End - y_Start);
+  int32_t num = (int32_t)(major - x_Start) * dy - dx / 2;
+  int16_t k = (num > 0) ? ((num + dx - 1) / dx) : 0;   // Rows stepped so far, as in drawLine()
+  uint8_t minor = (y_Start < y_End) ? (y_Start + k) : (y_Start - k);
+
+  if (Steep)
+  {
+    x = minor;
+  }
+  else
+  {
+    y = minor;
+  }
+  return true;
+}
+
+/**********************************************************
+Description: get the Span of a line in a row
+Parameters: x_Start, y_Start, x_End, y_End : The line, as given to drawLine().
+            y : Row.
+            x_Min, x_Max : Span widened to the columns drawLine() sets in row y
+                           (unchanged if the line has no pixel there).
+Return:
+Others: Same rounding as drawLine() : a steep line has one pixel per row, found by
+        linePoint(); a shallow one has a run of steps, solved from the error term.
+**********************************************************/
+void BMD31M090_Canvas::lineSpan(uint8_t x_Start, uint8_t y_Start, uint8_t x_End, uint8_t y_End, uint8_t y, int16_t &x_Min, int16_t &x_Max)
+{
+  int16_t first, last, k;
+
+  if (abs(y_End - y_Start) > abs(x_End - x_Start))
+  {
+    uint8_t x = 0;
+    if (linePoint(x_Start, y_Start, x_End, y_End, x, y))
+    {
+      first = x;
+      last = x;
+    }
+    else
+    {
+      return;
+    }
+  }
+  else
+  {
+    if (x_Start > x_End)
+    {
+      _swapValue_uint8_t(x_Start, x_End);
+      _swapValue_uint8_t(y_Start, y_End);
+    }
+    int16_t dx = x_End - x_Start;
+    int16_t dy = abs(y_End - y_Start);
+
+    k = (y_Start < y_End) ? (y - y_Start) : (y_Start - y);   // Rows stepped to reach y
+    if ((k < 0) || (k > dy))
+    {
+      return;
+    }
+    first = 0;
+    last = dx;
+    if (dy > 0)
+    {
+      if (k > 0)
+      {
+        first = ((int32_t)(k - 1) * dx + dx / 2) / dy + 1;     // First step k rows away
+      }
+      k = ((int32_t)k * dx + dx / 2) / dy;                      // Last step k rows away
+      last = (k < last) ? k : last;
+    }
+    first += x_Start;
+    last += x_Start;
+  }
+  x_Min = (first < x_Min) ? first : x_Min;
+  x_Max = (last > x_Max) ? last : x_Max;
+}
+
+/**********************************************************
+Description: plot a Pixel without clipping
+Parameters: x: Column, already inside the clip rectangle.
+            y: Row, already inside the clip rectangle.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Inner loop of the primitives that clip once, before drawing.
+**********************************************************/
+void BMD31M090_Canvas::plotPixel(uint8_t x, uint8_t y, uint8_t pixelColor)
+{
+  uint8_t *row = pageRow(y / 8);
+
+  if (row == NULL)
+  {
+    return;
+  }
+
+  switch (pixelColor)
+  {
+    case pixelColor_BLACK:
+      row[x] &= ~(1 << (y & 7));
+      markDirty(x, x, y / 8);
+      break;
+
+    case pixelColor_WHITE:
+      row[x] |= (1 << (y & 7));
+      markDirty(x, x, y / 8);
+      break;
+
+    case pixelColor_INVERSE:
+      row[x] ^= (1 << (y & 7));
+      markDirty(x, x, y / 8);
+      break;
+
+    default:
+      /* BMD31M090 doesn't support colors other than black and white. */
+      break;
+  }
+}
+/**********************************************************
+Description: transpose a bitmap Block
+Parameters: block : 8 bitmap rows, top row first, MSB = left column.
+                    Returns 8 page-layout columns, left column first, bit 0 = top row.
+Return:
+Others: 8 x 8 bit-matrix transpose with three rounds of masked swaps on two 32-bit
+        words (Hacker's Delight, section 7-3). Loading the rows bottom first turns
+        its MSB-first rows into the LSB-on-top order of the panel.
+**********************************************************/
+void BMD31M090_Canvas::transposeBlock(uint8_t *block)
+{
+  uint32_t x, y, t;
+
+  x = ((uint32_t)block[7] << 24) | ((uint32_t)block[6] << 16) | ((uint32_t)block[5] << 8) | block[4];
+  y = ((uint32_t)block[3] << 24) | ((uint32_t)block[2] << 16) | ((uint32_t)block[1] << 8) | block[0];
+
+  t = (x ^ (x >> 7)) & 0x00AA00AAUL;  x = x ^ t ^ (t << 7);   // Swap bits within 2 x 2 blocks
+  t = (y ^ (y >> 7)) & 0x00AA00AAUL;  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCCUL; x = x ^ t ^ (t << 14);  // Swap 2 x 2 blocks within 4 x 4 blocks
+  t = (y ^ (y >> 14)) & 0x0000CCCCUL; y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0UL) | ((y >> 4) & 0x0F0F0F0FUL);          // Swap 4 x 4 blocks
+  y = ((x << 4) & 0xF0F0F0F0UL) | (y & 0x0F0F0F0FUL);
+  x = t;
+
+  block[0] = x >> 24;
+  block[1] = x >> 16;
+  block[2] = x >> 8;
+  block[3] = x;
+  block[4] = y >> 24;
+  block[5] = y >> 16;
+  block[6] = y >> 8;
+  block[7] = y;
+}
+
+/**********************************************************
+Description: fill a column Span of a page row
+Parameters: row : Page row returned by pageRow().
+            x_Start : First column.
+            x_End : Last column (already clipped to the buffer).
+            mask : Pixels of each byte to change.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Every color is applied as byte = (byte & keep) ^ flip, so the loop has no
+        branch. With BMD31M090_WORD_FILL the aligned middle of the span is
+        processed 4 bytes at a time. The caller marks the span dirty.
+**********************************************************/
+void BMD31M090_Canvas::fillSpan(uint8_t *row, uint8_t x_Start, uint8_t x_End, uint8_t mask, uint8_t pixelColor)
+{
+  uint8_t keep = (pixelColor == pixelColor_INVERSE) ? 0xFF : (uint8_t)~mask;
+  uint8_t flip = (pixelColor == pixelColor_BLACK) ? 0x00 : mask;
+  uint8_t *p = &row[x_Start];
+  uint8_t *end = &row[x_End] + 1;
+
+#if BMD31M090_WORD_FILL
+  uint32_t keepWord = keep * 0x01010101UL;
+  uint32_t flipWord = flip * 0x01010101UL;
+  uint32_t word;
+
+  while ((p < end) && ((uintptr_t)p & 3))
+  {
+    *p = (*p & keep) ^ flip;
+    p++;
+  }
+  for (; (end - p) >= 4; p += 4)
+  {
+    memcpy(&word, p, 4);                            // Aligned : compiles to one load and one store
+    word = (word & keepWord) ^ flipWord;
+    memcpy(p, &word, 4);
+  }
+#endif
+  for (; p < end; p++)
+  {
+    *p = (*p & keep) ^ flip;
+  }
+}
+
+/**********************************************************
+Description: fill a Box given by its corners
+Parameters: x_Start : Left column (may be outside the buffer).
+            y_Start : Top row (may be outside the buffer).
+            x_End : Right column.
+            y_End : Bottom row.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: The box is clipped to the clip rectangle once. Then each page is one fillSpan() with a
+        head mask on the top page, a tail mask on the bottom page and whole bytes
+        in between; the touched spans are marked dirty. A one-row box is a span.
+**********************************************************/
+void BMD31M090_Canvas::fillBox(int16_t x_Start, int16_t y_Start, int16_t x_End, int16_t y_End, uint8_t pixelColor)
+{
+  uint8_t page_Start, page_End, mask;
+  uint8_t *row;
+
+  x_Start = (x_Start < _clipXStart) ? _clipXStart : x_Start;
+  y_Start = (y_Start < _clipYStart) ? _clipYStart : y_Start;
+  x_End = (x_End > _clipXEnd) ? _clipXEnd : x_End;
+  y_End = (y_End > _clipYEnd) ? _clipYEnd : y_End;
+  if ((x_Start > x_End) || (y_Start > y_End) || (pixelColor > pixelColor_INVERSE))
+  {
+    return;
+  }
+  page_Start = y_Start / 8;
+  page_End = y_End / 8;
+
+  for (uint8_t page = page_Start; page <= page_End; page++)
+  {
+    mask = 0xFF;
+    if (page == page_Start)
+    {
+      mask &= 0xFF << (y_Start & 7);                // Head : rows from y_Start down
+    }
+    if (page == page_End)
+    {
+      mask &= 0xFF >> (7 - (y_End & 7));            // Tail : rows up to y_End
+    }
+    row = pageRow(page);
+    if (row == NULL)
+    {
+      continue;                                     // Page mode : not the page being rendered
+    }
+    fillSpan(row, x_Start, x_End, mask, pixelColor);
+    markDirty(x_Start, x_End, page);
+  }
+}
+
+/**********************************************************
+Description: draw a Rounded shape as horizontal spans
+Parameters: x : Left column of the shape (may be outside the buffer).
+            y : Top row of the shape (may be outside the buffer).
+            radiusX : Horizontal corner radius (up to 127).
+            radiusY : Vertical corner radius (up to 127).
+            gapX : Columns between the centers of the left and right corners.
+            gapY : Rows between the centers of the top and bottom corners.
+            fill : true to fill the shape, false for the outline only.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: An ellipse has no gap; a rounded rectangle has four quarter circles
+        pulled apart by the gaps. The corner curve is walked once with the
+        midpoint rule (pixel centers within the radii plus half a pixel),
+        incrementally from row to row. Each row of the outline is the run between
+        the half-width of this row and the next one, so every pixel is written
+        once and pixelColor_INVERSE works; each row of a fill is one span.
+**********************************************************/
+void BMD31M090_Canvas::drawRounded(int16_t x, int16_t y, uint8_t radiusX, uint8_t radiusY, int16_t gapX, int16_t gapY, bool fill, uint8_t pixelColor)
+{
+  int16_t x_Left = x + radiusX;                     // Center column of the left corners
+  int16_t x_Right = x_Left + gapX;                  // Center column of the right corners
+  int16_t y_Top = y + radiusY;                      // Center row of the top corners
+  int16_t y_Bottom = y_Top + gapY;                  // Center row of the bottom corners
+  uint32_t a = (2UL * radiusX + 1) * (2UL * radiusX + 1);
+  uint32_t b = (2UL * radiusY + 1) * (2UL * radiusY + 1);
+  uint32_t ab = a * b;                              // < 2^32 with radii up to 127
+  int16_t halfWidth = radiusX;                      // Half-width of the curve on the current row
+  int16_t nextWidth, inner;
+
+  if (pixelColor > pixelColor_INVERSE)
+  {
+    return;
+  }
+
+  for (int16_t dy = 0; dy <= radiusY; dy++)
+  {
+    /* Half-width of the next row : largest w with (w / (rx + 0.5))^2 + (dy / (ry + 0.5))^2 <= 1 */
+    nextWidth = -1;
+    if (dy < radiusY)
+    {
+      uint32_t limit = ab - 4UL * (dy + 1) * (dy + 1) * a;
+      nextWidth = halfWidth;
+      while ((4UL * nextWidth * nextWidth * b) > limit)
+      {
+        nextWidth--;
+      }
+    }
+
+    inner = nextWidth + 1;                          // First column of this row's run
+    inner = (inner > halfWidth) ? halfWidth : inner;
+    for (uint8_t half = 0; half < (((dy == 0) && (gapY == 0)) ? 1 : 2); half++)
+    {
+      int16_t row = half ? (y_Bottom + dy) : (y_Top - dy);
+      if (fill || (nextWidth < 0) || ((x_Left - inner) >= (x_Right + inner)))
+      {
+        fillBox(x_Left - halfWidth, row, x_Right + halfWidth, row, pixelColor);
+      }
+      else
+      {
+        fillBox(x_Left - halfWidth, row, x_Left - inner, row, pixelColor);
+        fillBox(x_Right + inner, row, x_Right + halfWidth, row, pixelColor);
+      }
+    }
+    halfWidth = nextWidth;
+  }
+
+  /* Straight part between the top and bottom corners */
+  if (gapY > 1)
+  {
+    if (fill)
+    {
+      fillBox(x, y_Top + 1, x_Right + radiusX, y_Bottom - 1, pixelColor);
+    }
+    else
+    {
+      fillBox(x, y_Top + 1, x, y_Bottom - 1, pixelColor);
+      if ((x_Right + radiusX) != x)
+      {
+        fillBox(x_Right + radiusX, y_Top + 1, x_Right + radiusX, y_Bottom - 1, pixelColor);
+      }
+    }
+  }
+}
+
+/**********************************************************
+Description: mark a column span of a page as changed
+Parameters: x_Start : First changed column.
+            x_End : Last changed column.
+            page : Page of the span, 0 at top page to 7 at bottom page.
+Return:
+Others: The span is merged into the page's dirty range sent by the next display().
+**********************************************************/
+void BMD31M090_Canvas::markDirty(uint8_t x_Start, uint8_t x_End, uint8_t page)
+{
+  if (x_Start < _dirtyStart[page])
+  {
+    _dirtyStart[page] = x_Start;
+  }
+  if (x_End > _dirtyEnd[page])
+  {
+    _dirtyEnd[page] = x_End;
+  }
+  if (_bufferAlias)
+  {
+    _bufferAlias->markDirty(x_Start, x_End, page);  // Panels showing this buffer changed too
+  }
+}
+
+/**********************************************************
+Description: mark the whole display as changed
+Parameters:
+Return:
+Others: The next display() sends the full frame.
+**********************************************************/
+void BMD31M090_Canvas::markAllDirty(void)
+{
+  uint8_t pageNum = (_displayHeight + 7) / 8;
+
+  memset(_dirtyStart, 0x00, pageNum);               // Pages past the panel stay clean
+  memset(_dirtyEnd, _displayWidth - 1, pageNum);
+  if (_bufferAlias)
+  {
+    _bufferAlias->markAllDirty();
+  }
+}
+
+/**********************************************************
+Description: set Pow
+Parameters: baseValue : Base Value.
+            indexValue : Index Value.
+Return: The value of baseValue^indexValue.
+Others:
+**********************************************************/
+uint32_t BMD31M090_Canvas::setPow(uint8_t baseValue, uint8_t indexValue)
+{
+  uint32_t result = 1;
+  while(indexValue--)
+  {
+    result *= baseValue;                            // result = baseValue^indexValue
+  }
+
+  return result;
+}
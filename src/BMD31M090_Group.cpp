@@ -0,0 +1,500 @@
+/*****************************************************************
+File:        BMD31M090_Group.cpp
+Author:      BEST MODULES CORP.
+Description: BMD31M090_Group.cpp drives two BMD31M090 panels on one bus
+             (e.g. addresses 0x3C and 0x3D) with interleaved transfers
+Version:     V1.0.3   --  2025-05-29
+******************************************************************/
+#include "BMD31M090_Group.h"
+
+/**********************************************************
+Description: Constructor
+Parameters: panel0: First panel (left panel in GROUP_SPANNED mode)
+            panel1: Second panel (right panel in GROUP_SPANNED mode)
+            mode: GROUP_INDEPENDENT, GROUP_MIRROR or GROUP_SPANNED
+Return:
+Others: Both panels must be begin()-ed with their own address on the same bus.
+**********************************************************/
+BMD31M090_Group::BMD31M090_Group(BMD31M090 &panel0, BMD31M090 &panel1, uint8_t mode)
+{
+  _panel[0] = &panel0;
+  _panel[1] = &panel1;
+  _mode = GROUP_INDEPENDENT;
+  setMode(mode);
+}
+
+/**********************************************************
+Description: set Group Mode
+Parameters: mode: GROUP_INDEPENDENT : each panel shows its own buffer.
+                  GROUP_MIRROR : draw on panel 0, both panels show it. Panel 1 streams
+                                 panel 0's buffer, its own buffer is not used.
+                  GROUP_SPANNED : draw through this object on a (width0 + width1) x height canvas.
+Return:
+Others: Waits for a running transfer. Only what is drawn into the buffers is shown :
+        BMD31M090::drawChar()/drawString() write the panel directly, so in GROUP_MIRROR
+        mode draw text with this object's drawString() (or panel 0's
+        BMD31M090_Canvas::drawString()), otherwise the next display() overwrites it.
+        GROUP_SPANNED offers drawPixel(), drawLine(), drawFastHLine(), drawFastVLine(),
+        fillRect(), clearRect(), drawBitmap() and drawString(); other shapes are drawn
+        on each panel with their coordinates.
+**********************************************************/
+void BMD31M090_Group::setMode(uint8_t mode)
+{
+  BMD31M090 *mirror = _panel[1];
+
+  while (displayPoll())
+  {
+  }
+
+  if (mode == GROUP_MIRROR)
+  {
+    mirror->shareBuffer(_panel[0]);
+  }
+  else if (_mode == GROUP_MIRROR)
+  {
+    mirror->shareBuffer(NULL);                      // Back to its own buffer
+  }
+  _mode = mode;
+}
+
+/**********************************************************
+Description: Push both panels' data to the Displays.
+Parameters:
+Return: 0 : Success, otherwise the Wire error code of the first panel that failed.
+Others: Blocking version of displayAsync()/displayPoll().
+**********************************************************/
+uint8_t BMD31M090_Group::display(void)
+{
+  while (displayPoll())
+  {
+  }
+  displayAsync();
+  while (displayPoll())
+  {
+  }
+
+  uint8_t ret = _panel[0]->getDisplayStatus();
+  return (ret != 0) ? ret : _panel[1]->getDisplayStatus();
+}
+
+/**********************************************************
+Description: start an asynchronous transfer to both panels
+Parameters: callback : Function called from displayPoll() when both panels are done (optional).
+Return: true if the transfer was started, false if one is still running.
+Others: In GROUP_MIRROR mode panel 1 streams panel 0's buffer (see BMD31M090::shareBuffer()).
+**********************************************************/
+bool BMD31M090_Group::displayAsync(BMD31M090_Callback callback)
+{
+  if (_busy)
+  {
+    return false;
+  }
+
+  _panel[0]->displayAsync();                        // First : in GROUP_MIRROR mode panel 1 follows its buffer swap
+  _panel[1]->displayAsync();
+
+  _callback = callback;
+  _busy = true;
+  return true;
+}
+
+/**********************************************************
+Description: advance the transfer to both panels
+Parameters:
+Return: true while the transfer is still running, false when both panels are done.
+Others: Each call sends one transaction, alternating between the panels, so
+        neither panel holds the bus for a whole frame.
+**********************************************************/
+bool BMD31M090_Group::displayPoll(void)
+{
+  if (!_busy)
+  {
+    return false;
+  }
+
+  if (!_panel[_nextPanel]->displayPoll())
+  {
+    _panel[_nextPanel ^ 1]->displayPoll();          // Only the other panel is left
+  }
+  _nextPanel ^= 1;
+
+  if (_panel[0]->displayBusy() || _panel[1]->displayBusy())
+  {
+    return true;
+  }
+
+  _busy = false;
+  if (_callback)
+  {
+    _callback();
+  }
+  return false;
+}
+
+/**********************************************************
+Description: check for a running transfer
+Parameters:
+Return: true if a displayAsync() transfer has not finished on both panels yet.
+Others:
+**********************************************************/
+bool BMD31M090_Group::displayBusy(void)
+{
+  return _busy;
+}
+
+/**********************************************************
+Description: get canvas Width
+Parameters:
+Return: Sum of both panel widths in GROUP_SPANNED mode, panel 0 width otherwise.
+Others:
+**********************************************************/
+uint16_t BMD31M090_Group::width(void)
+{
+  if (_mode == GROUP_SPANNED)
+  {
+    return (uint16_t)_panel[0]->_displayWidth + _panel[1]->_displayWidth;
+  }
+  return _panel[0]->_displayWidth;
+}
+
+/**********************************************************
+Description: get canvas Height
+Parameters:
+Return: Panel 0 height.
+Others:
+**********************************************************/
+uint8_t BMD31M090_Group::height(void)
+{
+  return _panel[0]->_displayHeight;
+}
+
+/**********************************************************
+Description: Clear contents of both display buffers
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BMD31M090_Group::clearDisplay(void)
+{
+  _panel[0]->clearDisplay();
+  if (_mode != GROUP_MIRROR)
+  {
+    _panel[1]->clearDisplay();
+  }
+}
+
+/**********************************************************
+Description: Set/Clear/Invert a single pixel of the canvas.
+Parameters: x: Column of canvas, 0 at left to (width() - 1) at right.
+            y: Row of canvas, 0 at top to (height() - 1) at bottom.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Pixels outside the canvas are ignored. Outside GROUP_SPANNED mode the
+        canvas is panel 0.
+**********************************************************/
+void BMD31M090_Group::drawPixel(int16_t x, int16_t y, uint8_t pixelColor)
+{
+  if ((x < 0) || (y < 0) || (x >= (int16_t)width()) || (y >= _panel[0]->_displayHeight))
+  {
+    return;
+  }
+
+  if (x < _panel[0]->_displayWidth)
+  {
+    _panel[0]->drawPixel(x, y, pixelColor);
+  }
+  else if (y < _panel[1]->_displayHeight)
+  {
+    _panel[1]->drawPixel(x - _panel[0]->_displayWidth, y, pixelColor);
+  }
+}
+
+/**********************************************************
+Description: draw Line on the canvas.
+Parameters: x_Start : Start point x coordinate.
+            y_Start : Start point y coordinate.
+            x_End : End point x coordinate.
+            y_End : End point y coordinate.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Lines may cross the seam between the panels.
+**********************************************************/
+void BMD31M090_Group::drawLine(int16_t x_Start, int16_t y_Start, int16_t x_End, int16_t y_End, uint8_t pixelColor)
+{
+  int16_t dx = abs(x_End - x_Start);
+  int16_t dy = -abs(y_End - y_Start);
+  int8_t xStep = (x_Start < x_End) ? 1 : -1;
+  int8_t yStep = (y_Start < y_End) ? 1 : -1;
+  int16_t errValue = dx + dy;
+
+  while (1)
+  {
+    drawPixel(x_Start, y_Start, pixelColor);
+    if ((x_Start == x_End) && (y_Start == y_End))
+    {
+      break;
+    }
+    if ((2 * errValue) >= dy)
+    {
+      errValue += dy;
+      x_Start += xStep;
+    }
+    if ((2 * errValue) <= dx)
+    {
+      errValue += dx;
+      y_Start += yStep;
+    }
+  }
+}
+
+/**********************************************************
+Description: draw a Horizontal Line on the canvas
+Parameters: x: Column of canvas.
+            y: Row of canvas.
+            width : Width of Line, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Split at the seam into one drawFastHLine() per panel.
+**********************************************************/
+void BMD31M090_Group::drawFastHLine(int16_t x, int16_t y, int16_t width, uint8_t pixelColor)
+{
+  int16_t seam = _panel[0]->_displayWidth;
+  int16_t x_End = x + width - 1;
+
+  if ((width <= 0) || (y < 0) || (y >= _panel[0]->_displayHeight) || (x_End < 0) || (x >= (int16_t)this->width()))
+  {
+    return;
+  }
+  if (x < 0)
+  {
+    x = 0;
+  }
+  if (x_End >= (int16_t)this->width())
+  {
+    x_End = this->width() - 1;
+  }
+
+  if (x < seam)
+  {
+    _panel[0]->drawFastHLine(x, y, ((x_End < seam) ? x_End : (seam - 1)) - x + 1, pixelColor);
+  }
+  if ((x_End >= seam) && (y < _panel[1]->_displayHeight))
+  {
+    int16_t x1 = (x < seam) ? 0 : (x - seam);
+    _panel[1]->drawFastHLine(x1, y, x_End - seam - x1 + 1, pixelColor);
+  }
+}
+
+/**********************************************************
+Description: draw a Vertical Line on the canvas
+Parameters: x: Column of canvas.
+            y: Row of canvas.
+            height : Height of Line, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others:
+**********************************************************/
+void BMD31M090_Group::drawFastVLine(int16_t x, int16_t y, int16_t height, uint8_t pixelColor)
+{
+  int16_t y_End = y + height - 1;
+  BMD31M090 *panel = _panel[0];
+
+  if ((height <= 0) || (x < 0) || (x >= (int16_t)width()))
+  {
+    return;
+  }
+  if (x >= panel->_displayWidth)
+  {
+    x -= panel->_displayWidth;
+    panel = _panel[1];
+  }
+  if (y < 0)
+  {
+    y = 0;
+  }
+  if (y_End >= panel->_displayHeight)
+  {
+    y_End = panel->_displayHeight - 1;
+  }
+  if (y <= y_End)
+  {
+    panel->drawFastVLine(x, y, y_End - y + 1, pixelColor);
+  }
+}
+
+/**********************************************************
+Description: fill a Rectangle on the canvas
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Split at the seam into one fillRect() per panel.
+**********************************************************/
+void BMD31M090_Group::fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t pixelColor)
+{
+  int16_t seam = _panel[0]->_displayWidth;
+  int16_t x_End = x + width - 1;
+  int16_t y_End = y + height - 1;
+
+  if ((width <= 0) || (height <= 0) || (x_End < 0) || (y_End < 0) ||
+      (x >= (int16_t)this->width()) || (y >= _panel[0]->_displayHeight))
+  {
+    return;
+  }
+  x = (x < 0) ? 0 : x;
+  y = (y < 0) ? 0 : y;
+  x_End = (x_End >= (int16_t)this->width()) ? (this->width() - 1) : x_End;
+  y_End = (y_End >= _panel[0]->_displayHeight) ? (_panel[0]->_displayHeight - 1) : y_End;
+
+  if (x < seam)
+  {
+    _panel[0]->fillRect(x, y, ((x_End < seam) ? x_End : (seam - 1)) - x + 1, y_End - y + 1, pixelColor);
+  }
+  if (x_End >= seam)
+  {
+    int16_t x1 = (x < seam) ? 0 : (x - seam);
+    _panel[1]->fillRect(x1, y, x_End - seam - x1 + 1, y_End - y + 1, pixelColor);
+  }
+}
+
+/**********************************************************
+Description: clear a Rectangle on the canvas
+Parameters: x: Column of the left edge.
+            y: Row of the top edge.
+            width : Width of the rectangle, in pixels.
+            height : Height of the rectangle, in pixels.
+Return:
+Others: fillRect() with pixelColor_BLACK.
+**********************************************************/
+void BMD31M090_Group::clearRect(int16_t x, int16_t y, int16_t width, int16_t height)
+{
+  fillRect(x, y, width, height, pixelColor_BLACK);
+}
+
+/**********************************************************
+Description: draw BMP on the canvas
+Parameters: x: Column of canvas.
+            y: Row of canvas.
+            Bitmap[]: Bitmap Name.
+            w: Width of Bitmap in pixels
+            h: Height of Bitmap in pixels
+            pixelColor: pixelColor_BLACK,
+                        pixelColor_WHITE,
+                        pixelColor_INVERSE,
+Return:
+Others: Same bitmap format as BMD31M090::drawBitmap(); may cross the seam.
+**********************************************************/
+void BMD31M090_Group::drawBitmap(int16_t x, int16_t y, const uint8_t *Bitmap, uint16_t w, uint8_t h, uint8_t pixelColor)
+{
+  uint16_t byteWidth = (w + 7) / 8;                 // Bitmap scanline pad = whole byte
+  uint8_t onColor = (pixelColor == pixelColor_WHITE) ? pixelColor_WHITE :
+                    (pixelColor == pixelColor_BLACK) ? pixelColor_BLACK : pixelColor_INVERSE;
+  uint8_t offColor = (pixelColor == pixelColor_WHITE) ? pixelColor_BLACK :
+                     (pixelColor == pixelColor_BLACK) ? pixelColor_WHITE : pixelColor_INVERSE;
+  uint8_t b = 0;
+
+  for (uint8_t j = 0; j < h; j++)
+  {
+    for (uint16_t i = 0; i < w; i++)
+    {
+      if (i & 7)
+      {
+        b <<= 1;
+      }
+      else
+      {
+        b = Bitmap[(j * byteWidth) + (i / 8)];
+      }
+      drawPixel(x + i, y + j, (b & 0x80) ? onColor : offColor);
+    }
+  }
+}
+
+/**********************************************************
+Description: set Font of both panels
+Parameters: font : FontTable_6X8, FontTable_8X16, FontTable_16X32 or FontTable_32X64.
+Return:
+Others: Used by drawString().
+**********************************************************/
+void BMD31M090_Group::setFont(const unsigned char* font)
+{
+  _panel[0]->setFont(font);
+  _panel[1]->setFont(font);
+}
+
+/**********************************************************
+Description: draw String on the canvas
+Parameters: x: Column of canvas, 0 at left to (width() - 1) at right.
+            row: Row page, 0 at top page to 7 at bottom page.
+            str : The string on FontTable.
+Return:
+Others: Drawn into the buffers (see BMD31M090_Canvas::drawString()), so it is shown
+        by display() in every mode. Wraps to the next text row at the right edge of
+        the canvas. A character crossing the seam is split : the part on panel 1
+        is drawn column by column. Characters starting left of the canvas are skipped.
+**********************************************************/
+void BMD31M090_Group::drawString(int16_t x, uint8_t row, uint8_t *str)
+{
+  BMD31M090 *panel = _panel[0];
+  int16_t seam = panel->_displayWidth;
+  uint8_t fontWidth = panel->_fontWidth;
+  uint8_t charPageNum = (panel->_fontHeight % 8) ? ((panel->_fontHeight / 8) + 1) : (panel->_fontHeight / 8);
+  uint8_t chr;
+
+  if ((panel->_font == NULL) || (fontWidth == 0))
+  {
+    return;
+  }
+
+  for (uint16_t j = 0; str[j] != '\0'; j++)
+  {
+    chr = ((str[j] < 32) || (str[j] > 127)) ? ' ' : str[j];
+    if (x >= 0)
+    {
+      if (x < seam)
+      {
+        panel->BMD31M090_Canvas::drawChar(x, row, chr);   // Clipped at the seam by panel 0
+      }
+      if (x >= seam)
+      {
+        _panel[1]->BMD31M090_Canvas::drawChar(x - seam, row, chr);
+      }
+      else if ((x + fontWidth) > seam)
+      {
+        /* Columns of the glyph beyond the seam, opaque like drawChar() */
+        const unsigned char *glyph = &panel->_font[panel->_fontOffset + (chr - 32) * (fontWidth * charPageNum)];
+        for (uint8_t col = seam - x; col < fontWidth; col++)
+        {
+          for (uint8_t page = 0; (page < charPageNum) && ((row + page) < BMD31M090_MAXPAGES); page++)
+          {
+            uint8_t bits = pgm_read_byte(&glyph[col + fontWidth * page]);
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+              _panel[1]->drawPixel(x + col - seam, (row + page) * 8 + bit, ((bits >> bit) & 1) ? pixelColor_WHITE : pixelColor_BLACK);
+            }
+          }
+        }
+      }
+    }
+
+    /* If it is judged that it exceeds the width of the canvas, set x = 0 and skip to the next text row */
+    x += fontWidth;
+    if (x > ((int16_t)width() - fontWidth))
+    {
+      x = 0;
+      row += charPageNum;
+    }
+  }
+}
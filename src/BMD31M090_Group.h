@@ -0,0 +1,48 @@
+/*****************************************************************
+File:             BMD31M090_Group.h
+Author:           BEST MODULES CORP.
+Description:      Define the class driving two BMD31M090 panels on one bus
+Version:          V1.0.3   --  2025-05-29
+******************************************************************/
+
+#ifndef _BMD31M090_GROUP_H_
+#define _BMD31M090_GROUP_H_
+
+#include "BMD31M090.h"
+
+/* Group Mode                                                 */
+#define GROUP_INDEPENDENT   0           // Each panel shows its own buffer
+#define GROUP_MIRROR        1           // Both panels show the buffer of panel 0
+#define GROUP_SPANNED       2           // Panel 0 | panel 1 form one (width0 + width1) x height canvas
+
+class BMD31M090_Group
+{
+  public:
+    BMD31M090_Group(BMD31M090 &panel0, BMD31M090 &panel1, uint8_t mode = GROUP_INDEPENDENT);
+    void setMode(uint8_t mode);
+    uint8_t display(void);
+    bool displayAsync(BMD31M090_Callback callback = NULL);
+    bool displayPoll(void);
+    bool displayBusy(void);
+    uint16_t width(void);
+    uint8_t height(void);
+    void clearDisplay(void);
+    void drawPixel(int16_t x, int16_t y, uint8_t pixelColor);
+    void drawLine(int16_t x_Start, int16_t y_Start, int16_t x_End, int16_t y_End, uint8_t pixelColor);
+    void drawFastHLine(int16_t x, int16_t y, int16_t width, uint8_t pixelColor);
+    void drawFastVLine(int16_t x, int16_t y, int16_t height, uint8_t pixelColor);
+    void fillRect(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t pixelColor);
+    void clearRect(int16_t x, int16_t y, int16_t width, int16_t height);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t *Bitmap, uint16_t w, uint8_t h, uint8_t pixelColor);
+    void setFont(const unsigned char* font);
+    void drawString(int16_t x, uint8_t row, uint8_t *str);
+
+  private:
+    BMD31M090 *_panel[2];
+    uint8_t _mode;
+    uint8_t _nextPanel = 0;                       // Panel served by the next displayPoll()
+    bool _busy = false;
+    BMD31M090_Callback _callback = NULL;
+};
+
+#endif
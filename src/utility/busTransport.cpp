@@ -0,0 +1,383 @@
+/*****************************************************************
+File:        busTransport.cpp
+Author:      BEST MODULES CORP.
+Description: Software I2C and fake bus transports of the BMD31M090 library
+Version:     V1.0.3   --  2025-05-29
+******************************************************************/
+#include "busTransport.h"
+
+#if (BMD31M090_BUS == BMD31M090_BUS_SOFT)
+
+/**********************************************************
+Description: Constructor
+Parameters: sdaPin: GPIO used as SDA (needs a pull-up resistor)
+            sclPin: GPIO used as SCL (needs a pull-up resistor)
+Return:
+Others:
+**********************************************************/
+BMD31M090_SoftBus::BMD31M090_SoftBus(uint8_t sdaPin, uint8_t sclPin)
+{
+  _sdaPin = sdaPin;
+  _sclPin = sclPin;
+}
+
+/**********************************************************
+Description: release both lines (bus idle)
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BMD31M090_SoftBus::begin(void)
+{
+  lineHigh(_sdaPin);
+  lineHigh(_sclPin);
+}
+
+/**********************************************************
+Description: set SCL Clock
+Parameters: clkFrequency: SCL frequency in Hz
+Return:
+Others: The resolution is 1us per half period; the real rate also depends
+        on the digitalWrite()/pinMode() speed of the core.
+**********************************************************/
+void BMD31M090_SoftBus::setClock(uint32_t clkFrequency)
+{
+  _halfPeriod = (clkFrequency >= 500000UL) ? 0 : (500000UL / clkFrequency);
+}
+
+/**********************************************************
+Description: set clock stretching Timeout
+Parameters: timeout: Limit in microseconds
+Return:
+Others:
+**********************************************************/
+void BMD31M090_SoftBus::setTimeout(uint32_t timeout)
+{
+  _timeout = timeout;
+}
+
+/**********************************************************
+Description: write one transaction
+Parameters: address: 7-bit device address
+            control: Control byte (0x00 : commands, 0x40 : GDDRAM data)
+            data: Bytes following the control byte
+            len: Number of bytes
+Return: 0 : Success, 2 : address NACK, 3 : data NACK, 5 : timeout
+Others:
+**********************************************************/
+uint8_t BMD31M090_SoftBus::write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len)
+{
+  uint8_t ret = 0;
+  bool ack = false;
+
+  /* START : SDA falls while SCL is high */
+  lineHigh(_sdaPin);
+  if (!sclHigh())
+  {
+    stop();
+    return 5;
+  }
+  delayMicroseconds(_halfPeriod);
+  lineLow(_sdaPin);
+  delayMicroseconds(_halfPeriod);
+  lineLow(_sclPin);
+
+  if (!writeByte(address << 1, ack))
+  {
+    ret = 5;
+  }
+  else if (!ack)
+  {
+    ret = 2;
+  }
+  else if (!writeByte(control, ack))
+  {
+    ret = 5;
+  }
+  else if (!ack)
+  {
+    ret = 3;
+  }
+
+  for (uint8_t i = 0; (i < len) && (ret == 0); i++)
+  {
+    if (!writeByte(data[i], ack))
+    {
+      ret = 5;
+    }
+    else if (!ack)
+    {
+      ret = 3;
+    }
+  }
+
+  stop();
+  return ret;
+}
+
+/**********************************************************
+Description: release a line (pulled high by the resistor)
+Parameters: pin: SDA or SCL pin
+Return:
+Others:
+**********************************************************/
+void BMD31M090_SoftBus::lineHigh(uint8_t pin)
+{
+  pinMode(pin, INPUT_PULLUP);
+}
+
+/**********************************************************
+Description: drive a line low
+Parameters: pin: SDA or SCL pin
+Return:
+Others:
+**********************************************************/
+void BMD31M090_SoftBus::lineLow(uint8_t pin)
+{
+  digitalWrite(pin, LOW);
+  pinMode(pin, OUTPUT);
+}
+
+/**********************************************************
+Description: release SCL and wait for it to go high
+Parameters:
+Return: false if a slave stretched the clock longer than the timeout.
+Others:
+**********************************************************/
+bool BMD31M090_SoftBus::sclHigh(void)
+{
+  uint32_t startTime = micros();
+
+  lineHigh(_sclPin);
+  while (digitalRead(_sclPin) == LOW)
+  {
+    if ((micros() - startTime) >= _timeout)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**********************************************************
+Description: write one byte, MSB first, and read the acknowledge bit
+Parameters: value: Byte to send
+            ack: Returns true if the slave acknowledged
+Return: false on clock stretching timeout.
+Others: SCL is low on entry and on return.
+**********************************************************/
+bool BMD31M090_SoftBus::writeByte(uint8_t value, bool &ack)
+{
+  for (uint8_t mask = 0x80; mask; mask >>= 1)
+  {
+    if (value & mask)
+    {
+      lineHigh(_sdaPin);
+    }
+    else
+    {
+      lineLow(_sdaPin);
+    }
+    delayMicroseconds(_halfPeriod);
+    if (!sclHigh())
+    {
+      return false;
+    }
+    delayMicroseconds(_halfPeriod);
+    lineLow(_sclPin);
+  }
+
+  lineHigh(_sdaPin);                                // Slave drives the acknowledge bit
+  delayMicroseconds(_halfPeriod);
+  if (!sclHigh())
+  {
+    return false;
+  }
+  ack = (digitalRead(_sdaPin) == LOW);
+  delayMicroseconds(_halfPeriod);
+  lineLow(_sclPin);
+  return true;
+}
+
+/**********************************************************
+Description: STOP : SDA rises while SCL is high
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BMD31M090_SoftBus::stop(void)
+{
+  lineLow(_sdaPin);
+  delayMicroseconds(_halfPeriod);
+  sclHigh();
+  delayMicroseconds(_halfPeriod);
+  lineHigh(_sdaPin);
+  delayMicroseconds(_halfPeriod);
+}
+
+#elif (BMD31M090_BUS == BMD31M090_BUS_FAKE)
+
+/**********************************************************
+Description: reset the fake panel and its counters
+Parameters:
+Return:
+Others: GDDRAM cleared, full address window, pointer at column 0 of page 0.
+**********************************************************/
+void BMD31M090_FakeBus::reset(void)
+{
+  clock = 0;
+  transactions = 0;
+  commandBytes = 0;
+  dataBytes = 0;
+  failNext = 0;
+  failData = false;
+  maxClock = 0;
+  memset(gddram, 0x00, sizeof(gddram));
+  _cmdLen = 0;
+  _colStart = 0;
+  _colEnd = FAKEBUS_WIDTH - 1;
+  _pageStart = 0;
+  _pageEnd = FAKEBUS_PAGES - 1;
+  _col = 0;
+  _page = 0;
+}
+
+/**********************************************************
+Description: write one transaction
+Parameters: address: 7-bit device address (ignored)
+            control: Control byte (0x00 : commands, 0x40 : GDDRAM data)
+            data: Bytes following the control byte
+            len: Number of bytes
+Return: 0 : Success, 2 : NACK injected through failNext or maxClock,
+        3 : data NACK injected through failNext with failData set (GDDRAM data only)
+Others: Commands are parsed so that GDDRAM data lands where a real panel
+        in horizontal addressing mode would put it. A failed transaction is
+        not counted, even when part of its data landed.
+**********************************************************/
+uint8_t BMD31M090_FakeBus::write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len)
+{
+  uint8_t ret = 0;
+
+  (void)address;
+  if (failNext)
+  {
+    failNext--;
+    if (!failData || (control != 0x40))
+    {
+      return 2;
+    }
+    len = len / 2;                                  // The bytes before the NACK reach the panel
+    ret = 3;
+  }
+  else if (maxClock && (clock > maxClock))
+  {
+    return 2;
+  }
+  else
+  {
+    transactions++;
+  }
+
+  if (control == 0x00)
+  {
+    commandBytes += len;
+    for (uint8_t i = 0; i < len; i++)
+    {
+      command(data[i]);
+    }
+    return 0;
+  }
+
+  if (ret == 0)
+  {
+    dataBytes += len;
+  }
+  for (uint8_t i = 0; i < len; i++)
+  {
+    gddram[_col + _page * FAKEBUS_WIDTH] = data[i];
+    if (_col < _colEnd)
+    {
+      _col++;
+      continue;
+    }
+    _col = _colStart;
+    _page = (_page < _pageEnd) ? (_page + 1) : _pageStart;
+  }
+  return ret;
+}
+
+/**********************************************************
+Description: parse one command byte
+Parameters: value: Command op-code or parameter
+Return:
+Others: Only the addressing commands change the fake panel; the parameters
+        of all other commands are counted and skipped.
+**********************************************************/
+void BMD31M090_FakeBus::command(uint8_t value)
+{
+  uint8_t paramNum;
+
+  if (_cmdLen < sizeof(_cmd))
+  {
+    _cmd[_cmdLen] = value;
+  }
+  _cmdLen++;
+
+  switch (_cmd[0])
+  {
+    case 0x21:                                      // Column start / end address
+    case 0x22:                                      // Page start / end address
+    case 0xA3:                                      // Vertical scroll area
+      paramNum = 2;
+      break;
+
+    case 0x20: case 0x81: case 0x8D: case 0xA8:
+    case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      paramNum = 1;
+      break;
+
+    case 0x26: case 0x27:                           // Horizontal scroll setup
+      paramNum = 6;
+      break;
+
+    case 0x29: case 0x2A:                           // Vertical and horizontal scroll setup
+      paramNum = 5;
+      break;
+
+    default:
+      paramNum = 0;
+      break;
+  }
+  if (_cmdLen <= paramNum)
+  {
+    return;                                         // Parameters still to come
+  }
+
+  if (_cmd[0] == 0x21)
+  {
+    _colStart = _cmd[1] % FAKEBUS_WIDTH;
+    _colEnd = _cmd[2] % FAKEBUS_WIDTH;
+    _col = _colStart;
+  }
+  else if (_cmd[0] == 0x22)
+  {
+    _pageStart = _cmd[1] % FAKEBUS_PAGES;
+    _pageEnd = _cmd[2] % FAKEBUS_PAGES;
+    _page = _pageStart;
+  }
+  else if ((_cmd[0] & 0xF8) == 0xB0)
+  {
+    _page = _cmd[0] & 0x07;                         // Page mode page address
+  }
+  else if (_cmd[0] < 0x10)
+  {
+    _col = (_col & 0xF0) | _cmd[0];                 // Page mode lower column address
+  }
+  else if (_cmd[0] < 0x20)
+  {
+    _col = ((_cmd[0] & 0x0F) << 4) | (_col & 0x0F); // Page mode higher column address
+  }
+  _cmdLen = 0;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*****************************************************************
+File:             busTransport.h
+Author:           BEST MODULES CORP.
+Description:      Bus transport policies of the BMD31M090 library
+Version:          V1.0.3   --  2025-05-29
+******************************************************************/
+
+#ifndef __BUSTRANSPORT_H
+#define __BUSTRANSPORT_H
+
+#include "Arduino.h"
+
+/* Bus transport selection, resolved at compile time                          */
+#define BMD31M090_BUS_WIRE    0         // Hardware Wire (TwoWire), default
+#define BMD31M090_BUS_SOFT    1         // Software (bit-banged) I2C on two GPIO pins
+#define BMD31M090_BUS_FAKE    2         // Recording fake with a simulated GDDRAM, for host builds
+#define BMD31M090_BUS_CUSTOM  3         // User class BMD31M090_CustomBus from BMD31M090_CUSTOM_BUS_HEADER
+                                        // (e.g. a DMA or SPI-style backend)
+#ifndef BMD31M090_BUS
+#define BMD31M090_BUS         BMD31M090_BUS_WIRE
+#endif
+
+/* Every transport provides the same non-virtual interface :
+     void begin(void);
+     void setClock(uint32_t clkFrequency);
+     void setTimeout(uint32_t timeout);                 // in microseconds
+     uint8_t write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len);
+   write() sends one transaction (START, address, control byte, data, STOP) and
+   returns 0 on success, or the Wire error code (2/3 : NACK, 5 : timeout).   */
+
+#if (BMD31M090_BUS == BMD31M090_BUS_WIRE)
+
+#include <Wire.h>
+
+class BMD31M090_WireBus
+{
+  public:
+    BMD31M090_WireBus(TwoWire *theWire = &Wire) : _wire(theWire) {}
+    void begin(void) { _wire->begin(); }
+    void setClock(uint32_t clkFrequency) { _wire->setClock(clkFrequency); }
+    void setTimeout(uint32_t timeout) { _wire->setWireTimeout(timeout, true); }
+    uint8_t write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len)
+    {
+      _wire->beginTransmission(address);
+      _wire->write(control);
+      _wire->write(data, len);
+      return _wire->endTransmission();
+    }
+
+  private:
+    TwoWire *_wire;
+};
+typedef BMD31M090_WireBus BMD31M090_Bus;
+
+#elif (BMD31M090_BUS == BMD31M090_BUS_SOFT)
+
+#if defined(SDA) && defined(SCL)
+  #define BMD31M090_SOFT_SDA  SDA
+  #define BMD31M090_SOFT_SCL  SCL
+#else
+  #define BMD31M090_SOFT_SDA  18
+  #define BMD31M090_SOFT_SCL  19
+#endif
+
+class BMD31M090_SoftBus
+{
+  public:
+    BMD31M090_SoftBus(uint8_t sdaPin = BMD31M090_SOFT_SDA, uint8_t sclPin = BMD31M090_SOFT_SCL);
+    void begin(void);
+    void setClock(uint32_t clkFrequency);
+    void setTimeout(uint32_t timeout);
+    uint8_t write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len);
+
+  private:
+    void lineHigh(uint8_t pin);
+    void lineLow(uint8_t pin);
+    bool sclHigh(void);
+    bool writeByte(uint8_t value, bool &ack);
+    void stop(void);
+    uint8_t _sdaPin;
+    uint8_t _sclPin;
+    uint16_t _halfPeriod = 2;                     // Half SCL period in microseconds
+    uint32_t _timeout = 25000;                    // Clock stretching limit in microseconds
+};
+typedef BMD31M090_SoftBus BMD31M090_Bus;
+
+#elif (BMD31M090_BUS == BMD31M090_BUS_FAKE)
+
+#define FAKEBUS_WIDTH   128
+#define FAKEBUS_PAGES   8
+
+class BMD31M090_FakeBus
+{
+  public:
+    BMD31M090_FakeBus(void) { reset(); }
+    void begin(void) {}
+    void setClock(uint32_t clkFrequency) { clock = clkFrequency; }
+    void setTimeout(uint32_t timeout) { (void)timeout; }
+    uint8_t write(uint8_t address, uint8_t control, const uint8_t *data, uint8_t len);
+    void reset(void);
+
+    /* Recorded bus activity, public so that host code can inspect it */
+    uint32_t clock;
+    uint32_t transactions;                        // Transactions acknowledged
+    uint32_t commandBytes;                        // Command bytes (control byte excluded)
+    uint32_t dataBytes;                           // GDDRAM bytes (control byte excluded)
+    uint16_t failNext;                            // Number of next transactions to NACK (error injection)
+    bool failData;                                // Injected NACKs of GDDRAM data : half of the bytes land first
+    uint32_t maxClock;                            // NACK every transaction above this clock (0 : no limit)
+    uint8_t gddram[FAKEBUS_WIDTH * FAKEBUS_PAGES];  // Simulated panel memory, horizontal addressing mode
+
+  private:
+    void command(uint8_t value);
+    uint8_t _cmd[3];                              // Command being parsed (op-code and parameters)
+    uint8_t _cmdLen;
+    uint8_t _colStart, _colEnd, _pageStart, _pageEnd;
+    uint8_t _col, _page;
+};
+typedef BMD31M090_FakeBus BMD31M090_Bus;
+
+#elif (BMD31M090_BUS == BMD31M090_BUS_CUSTOM)
+
+#include BMD31M090_CUSTOM_BUS_HEADER
+typedef BMD31M090_CustomBus BMD31M090_Bus;
+
+#else
+#error "BMD31M090_BUS : unknown bus transport"
+#endif
+
+#endif